@@ -3,85 +3,56 @@
 // Date:2020/11
 
 #include "model.h"
+#include "utils/obj_parser.h"
 #include <fstream>
 #include <iostream>
 //#define DEBUG_INPUT
 #define DEBUG
 
 
-bool Model::LoadObj(const std::string& file_path) {
-
-    std::ifstream file(file_path);
-    if (!file.is_open()) {
-        //std::cerr << "fail to open file " + file_path << std::endl;
-        return false;
-    }
-    std::string type;
-    int face_cnt = 0, vertex_cnt = 0;
-
-    std::vector<Eigen::Vector3d> m_vertexes;
-
-    while (file >> type) {
-        if (type == "v") {
-            // vertex
-            Eigen::Vector3d vt;
-            file >> vt(0) >> vt(1) >> vt(2);
-            m_vertexes.push_back(vt);
-        } else if (type == "f") {
-            
-            std::string token;
-            std::vector<int> index_v;
-            std::string line;
-            getline(file, line);
-            std::stringstream ss(line);
-            while(getline(ss, token, ' '))
-            {
-                if (token.size() == 0 || token[0] == '\r' || !(token[0] >= '0'&&token[0]<='9') ) continue;
-#ifdef DEBUG_INPUT
-                std::cout<<"DEBUG(BCHO): LoadObj(): token:"<<token<<"("<<std::stoi(token) - 1<<")"<<std::endl;
-#endif
-                index_v.push_back(std::stoi(token) - 1);
+namespace {
+    //builds one `Plane` per face from the streamed vertices
+    class ModelObjSink : public CommonUtils::ObjSink {
+    public:
+        explicit ModelObjSink(std::vector<Plane>& planes) : planes_(planes) {}
+        void AddVertex(const Eigen::Vector3d& p) override { vertices_.push_back(p); }
+        void AddFace(const index_t* ids, size_t num_points) override {
+            if(num_points == 3) {
+                planes_.emplace_back(vertices_[ids[0]], vertices_[ids[1]], vertices_[ids[2]]);
+                return;
+            }
+            points_.clear();
+            for(size_t i = 0 ; i < num_points ; i++) {
+                points_.emplace_back(vertices_[ids[i]]);
             }
+            planes_.emplace_back(points_);
+        }
 
-            if (index_v.size() > 2) {
+    private:
+        std::vector<Plane>& planes_;
+        std::vector<Eigen::Vector3d> vertices_;
+        std::vector<Eigen::Vector3d> points_;  //reused by every face
+    };
+}
+
+bool Model::LoadObj(const std::string& file_path) {
 #ifdef TRIANGULAR
-                for(int i = 0 ; i < index_v.size() ; i+=2) {
-                    // int nxt_i = (i + 1)%(index_v.size());
-                    int nxt_i = i + 1;
-                    if(nxt_i >= index_v.size()) {
-                        continue;
-                    }
-                    int after_nxt_i = (i + 2)%(index_v.size());
-
-                    Eigen::Vector3d &a = m_vertexes[index_v[i]],
-                         &b = m_vertexes[index_v[nxt_i]], &c = m_vertexes[index_v[after_nxt_i]];
-                    // Vec3f &normal = Normalize(Cross(b - a, c - b));
-
-                    // face.m_normal = normal;
-                    // for (auto &i : vertex_idx) {
-                    //     face.m_vertexes.push_back(m_vertexes[i]);
-                    //     vertex_cnt++;
-                    // }
-                    planes_.push_back(Plane(a,b,c));
-                    vertex_cnt += 3;
-                    face_cnt++;
-                }
+    const bool b_triangulate = true;
 #else
-                std::vector<Eigen::Vector3d> vertexes;
-                for(int i = 0 ; i < index_v.size() ; i++) {
-                    vertexes.emplace_back(m_vertexes[index_v[i]]);
-                }
-                planes_.push_back(vertexes);
-                vertex_cnt += vertexes.size();
-                face_cnt++;
-#endif 
-            }
-        }
+    const bool b_triangulate = false;
+#endif
+    const size_t first_plane = planes_.size();
+    ModelObjSink sink(planes_);
+    if(!CommonUtils::ParseObjFile(file_path, sink, b_triangulate)) {
+        return false;
+    }
+    size_t vertex_cnt = 0;
+    for(size_t i = first_plane ; i < planes_.size() ; i++) {
+        vertex_cnt += planes_[i].NumPoints();
     }
-    file.close();
     
     ConstructRandomColors();
-    std::cout << "Model has " << face_cnt << " faces and " << vertex_cnt << " vertexes"
+    std::cout << "Model has " << planes_.size() - first_plane << " faces and " << vertex_cnt << " vertexes"
          << std::endl;
     return true;
 }
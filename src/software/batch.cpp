@@ -0,0 +1,50 @@
+#include "subdivision/batch_subdivision.h"
+#include <cstring>
+
+void PrintUsage() {
+    std::cout<<"Please enter batchSubdivisionSurface [-m loop|catmull|doo] [-l levels] [-t threads] [-o output_dir] [-f obj|ply] [-w tolerance] "
+             <<"[obj_path|ply_path|mesh_dir|list.txt]...\n";
+}
+
+int main(int argc, const char* argv[]){
+    SubDivision::BatchOptions options;
+    std::vector<std::string> input_paths;
+    for(int i = 1 ; i < argc ; i++) {
+        const bool b_has_value = i + 1 < argc;
+        if(std::strcmp(argv[i], "-m") == 0 && b_has_value) {
+            if(!SubDivision::ParseMethod(argv[++i], options.method)) {
+                std::cout<<"Unknown subdivision method "<<argv[i]<<"\n";
+                return 1;
+            }
+        } else if(std::strcmp(argv[i], "-l") == 0 && b_has_value) {
+            options.num_levels = std::atoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-t") == 0 && b_has_value) {
+            options.num_threads = std::atoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-o") == 0 && b_has_value) {
+            options.output_dir = argv[++i];
+        } else if(std::strcmp(argv[i], "-f") == 0 && b_has_value) {
+            options.output_extension = std::string(".") + argv[++i];
+        } else if(std::strcmp(argv[i], "-w") == 0 && b_has_value) {
+            options.weld_tolerance = std::atof(argv[++i]);
+        } else if(argv[i][0] == '-') {
+            PrintUsage();
+            return 1;
+        } else {
+            input_paths.emplace_back(argv[i]);
+        }
+    }
+    if(input_paths.empty()) {
+        PrintUsage();
+        return 0;
+    }
+
+    SubDivision::BatchSubdivision batch(options);
+    for(const auto& path : input_paths) {
+        if(!batch.AddPath(path)) {
+            return 1;
+        }
+    }
+    const bool b_success = batch.Run();
+    batch.PrintSummary();
+    return b_success ? 0 : 1;
+}
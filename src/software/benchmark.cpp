@@ -0,0 +1,579 @@
+#include "subdivision/solver_factory.h"
+#include "subdivision/loop_solver.h"
+#include "subdivision/catmull_solver.h"
+#include "subdivision/doo_solver.h"
+#include "subdivision/mesh_generator.h"
+#include "utils/flat_hash_map.h"
+#include "utils/hash_table.h"
+#include "utils/io_utils.h"
+#include "utils/ply_reader.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <set>
+#include <sstream>
+
+using CommonUtils::index_t;
+using SubDivision::Mesh;
+
+struct Options {
+    std::vector<std::string> input_paths;
+    std::vector<SubDivision::SubdivisionMethod> methods;
+    int num_levels = 3;  //benchmark the refinement of level 0 .. num_levels - 1
+    int num_warmup = 1;
+    int num_repetitions = 5;
+    size_t num_threads = 0;  //threads of the mapped obj loader, 0: hardware concurrency
+    std::string json_path;
+    bool b_hash_tables = false;  //also time the uniform maps of the shader
+};
+
+//samples of one phase for one (mesh, method, level)
+struct PhaseSamples {
+    std::string name;
+    std::vector<double> seconds;
+};
+
+struct BenchmarkCase {
+    std::string mesh_name;
+    SubDivision::SubdivisionMethod method;
+    int level;
+    size_t num_vertices, num_edges, num_polygons;
+    std::vector<PhaseSamples> phases;  //in execution order
+};
+
+//every loader that reads one file (both obj loaders, or the ply reader)
+struct LoaderCase {
+    std::string mesh_name;
+    size_t num_bytes;
+    std::vector<PhaseSamples> loaders;
+};
+
+//one key count for every hash table, a phase is `num_keys` operations
+struct HashTableCase {
+    size_t num_keys;
+    std::vector<PhaseSamples> phases;
+};
+
+struct Statistics {
+    double min, mean, median, p95;
+};
+
+Statistics ComputeStatistics(std::vector<double> samples) {
+    Statistics stats = {0.0, 0.0, 0.0, 0.0};
+    if(samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    const size_t num_samples = samples.size();
+    stats.min = samples.front();
+    for(const double sample : samples) {
+        stats.mean += sample;
+    }
+    stats.mean /= num_samples;
+    stats.median = num_samples % 2 ? samples[num_samples / 2]
+                                   : 0.5 * (samples[num_samples / 2 - 1] + samples[num_samples / 2]);
+    //nearest rank
+    const size_t rank = static_cast<size_t>(std::ceil(0.95 * num_samples));
+    stats.p95 = samples[std::max<size_t>(rank, 1) - 1];
+    return stats;
+}
+
+//time every phase of one repetition, samples are only kept after the warm-up
+class PhaseRecorder {
+public:
+    PhaseRecorder(BenchmarkCase& benchmark_case, bool b_record)
+        : benchmark_case_(benchmark_case), b_record_(b_record) {}
+
+    void Time(const std::string& name, const std::function<void()>& func) {
+        CommonUtils::Timer timer;
+        func();
+        const double seconds = timer.ElapsedSeconds();
+        if(!b_record_) {
+            return;
+        }
+        auto& phases = benchmark_case_.phases;
+        auto it = std::find_if(phases.begin(), phases.end(),
+                               [&name](const PhaseSamples& phase) { return phase.name == name; });
+        if(it == phases.end()) {
+            phases.emplace_back(PhaseSamples{name, {}});
+            it = phases.end() - 1;
+        }
+        it->seconds.emplace_back(seconds);
+    }
+
+private:
+    BenchmarkCase& benchmark_case_;
+    bool b_record_;
+};
+
+//flatten a mesh back into the input arrays of `Mesh::SetUp`
+void ExtractArrays(const Mesh& mesh, std::vector<Eigen::Vector3d>& vertices,
+                   std::vector<std::vector<index_t>>& polygons) {
+    vertices.clear();
+    polygons.clear();
+    vertices.reserve(mesh.Vertices().size());
+    for(const auto& vertex : mesh.Vertices()) {
+        vertices.emplace_back(vertex->p);
+    }
+    polygons.reserve(mesh.Polygons().size());
+    for(const auto& polygon : mesh.Polygons()) {
+        polygons.emplace_back(polygon->points);
+    }
+}
+
+//run one repetition of the refinement of `mesh`, phase by phase as in `Run()`
+void RunPhases(SubDivision::SubdivisionMethod method, const Mesh& mesh,
+               PhaseRecorder& recorder, Mesh& updated_mesh) {
+    std::vector<std::vector<index_t>> polygons;
+    if(method == SubDivision::kLoop) {
+        SubDivision::LoopSolver solver;
+        std::vector<index_t> updated_edge_points, updated_vertices;
+        recorder.Time("UpdateEdgePoints", [&]() { solver.UpdateEdgePoints(mesh, updated_edge_points); });
+        recorder.Time("UpdateVertices", [&]() { solver.UpdateVertices(mesh, updated_vertices); });
+        recorder.Time("Divide", [&]() { solver.Divide(mesh, updated_edge_points, updated_vertices, polygons); });
+        recorder.Time("MakeUpMesh", [&]() { solver.MakeUpMesh(polygons, updated_mesh); });
+    } else if(method == SubDivision::kCatmullClark) {
+        SubDivision::CatmullClarkSolver solver;
+        std::vector<Eigen::Vector3d> edge_points, face_points;
+        std::vector<index_t> updated_face_points, updated_edge_points, updated_vertices;
+        recorder.Time("GetEdgePoints", [&]() { edge_points = solver.GetEdgePoints(mesh); });
+        recorder.Time("GetFacePoints", [&]() { face_points = solver.GetFacePoints(mesh); });
+        recorder.Time("UpdateFacePoints", [&]() { solver.UpdateFacePoints(mesh, face_points, updated_face_points); });
+        recorder.Time("UpdateEdgePoints", [&]() { solver.UpdateEdgePoints(mesh, face_points, updated_edge_points); });
+        recorder.Time("UpdateVertices", [&]() {
+            solver.UpdateVertices(mesh, face_points, edge_points, updated_vertices);
+        });
+        recorder.Time("Divide", [&]() {
+            solver.Divide(mesh, updated_face_points, updated_edge_points, updated_vertices, polygons);
+        });
+        recorder.Time("MakeUpMesh", [&]() { solver.MakeUpMesh(polygons, updated_mesh); });
+    } else {
+        SubDivision::DooSabinSolver solver;
+        std::vector<Eigen::Vector3d> edge_points, face_points;
+        std::vector<std::vector<index_t>> updated_polygons, updated_edge_polygons, updated_vertex_polygons;
+        std::map<index_t, std::map<index_t, index_t>> indexed_vertices;
+        recorder.Time("GetEdgePoints", [&]() { edge_points = solver.GetEdgePoints(mesh); });
+        recorder.Time("GetFacePoints", [&]() { face_points = solver.GetFacePoints(mesh); });
+        recorder.Time("UpdateVertices", [&]() {
+            solver.UpdateVertices(mesh, face_points, edge_points, indexed_vertices, updated_vertex_polygons);
+        });
+        recorder.Time("UpdatedEdgePolygon", [&]() {
+            solver.UpdatedEdgePolygon(mesh, indexed_vertices, updated_edge_polygons);
+        });
+        recorder.Time("UpdateVertexPolygon", [&]() {
+            solver.UpdateVertexPolygon(mesh, indexed_vertices, updated_vertex_polygons);
+        });
+        recorder.Time("Divide", [&]() {
+            solver.Divide(mesh, updated_polygons, updated_edge_polygons, updated_vertex_polygons, polygons);
+        });
+        recorder.Time("MakeUpMesh", [&]() { solver.MakeUpMesh(polygons, updated_mesh); });
+    }
+}
+
+//benchmark every phase with `mesh` as input, `updated_mesh` receives the next level
+BenchmarkCase RunCase(const std::string& mesh_name, SubDivision::SubdivisionMethod method, int level,
+                      const Mesh& mesh, const Options& options, CommonUtils::ThreadPool& pool,
+                      std::unique_ptr<Mesh>& updated_mesh) {
+    BenchmarkCase benchmark_case;
+    benchmark_case.mesh_name = mesh_name;
+    benchmark_case.method = method;
+    benchmark_case.level = level;
+    benchmark_case.num_vertices = mesh.Vertices().size();
+    benchmark_case.num_edges = mesh.Edges().size();
+    benchmark_case.num_polygons = mesh.Polygons().size();
+
+    std::vector<Eigen::Vector3d> vertices;
+    std::vector<std::vector<index_t>> polygons;
+    ExtractArrays(mesh, vertices, polygons);
+
+    for(int i = 0 ; i < options.num_warmup + options.num_repetitions ; i++) {
+        PhaseRecorder recorder(benchmark_case, i >= options.num_warmup);
+        Mesh setup_mesh;
+        recorder.Time("Mesh::SetUp", [&]() { setup_mesh.SetUp(vertices, polygons); });
+        updated_mesh.reset(new Mesh());
+        RunPhases(method, mesh, recorder, *updated_mesh);
+        std::vector<float> triangular_mesh;
+        size_t num_vertex;
+        recorder.Time("ConvertToTriangularMesh", [&]() {
+            std::tie(triangular_mesh, num_vertex) = mesh.ConvertToTriangularMesh();
+        });
+        SubDivision::IndexedTriangles indexed_mesh;
+        recorder.Time("ConvertToIndexedMesh", [&]() { mesh.ConvertToIndexedMesh(indexed_mesh, &pool); });
+    }
+    return benchmark_case;
+}
+
+//time `CommonUtils::LoadObj` (one thread, a vector per polygon) against `CommonUtils::LoadObjMapped`
+//(chunks in parallel, compressed rows as `Mesh::SetUp` takes them), the samples are whole loads;
+//a ply file is timed with `CommonUtils::LoadPly` only; false if the file cannot be read
+bool RunLoaderCase(const std::string& input_path, const Options& options, CommonUtils::ThreadPool& pool,
+                   LoaderCase& loader_case) {
+    std::error_code error;
+    loader_case.mesh_name = std::filesystem::path(input_path).stem().string();
+    loader_case.num_bytes = std::filesystem::file_size(input_path, error);
+    if(error) {
+        std::cerr << "fail to open file " + input_path + ": " + error.message() << std::endl;
+        return false;
+    }
+    if(std::filesystem::path(input_path).extension() == ".ply") {
+        loader_case.loaders = {{"LoadPly", {}}};
+    } else {
+        loader_case.loaders = {{"LoadObj", {}}, {"LoadObjMapped", {}}};
+    }
+
+    for(int i = 0 ; i < options.num_warmup + options.num_repetitions ; i++) {
+        for(auto& loader : loader_case.loaders) {
+            std::vector<Eigen::Vector3d> vertices;
+            std::vector<std::vector<index_t>> polygons;
+            std::vector<index_t> face_offsets, face_indices;
+            CommonUtils::Timer timer;
+            if(loader.name == "LoadObj") {
+                CommonUtils::LoadObj(input_path, vertices, polygons, false, false);
+            } else if(loader.name == "LoadPly") {
+                CommonUtils::LoadPly(input_path, vertices, face_offsets, face_indices);
+            } else {
+                CommonUtils::LoadObjMapped(input_path, vertices, face_offsets, face_indices, false, &pool);
+            }
+            if(i >= options.num_warmup) {
+                loader.seconds.emplace_back(timer.ElapsedSeconds());
+            }
+        }
+    }
+    return true;
+}
+
+typedef CommonUtils::HashTable<unsigned int, unsigned int, CommonUtils::DjB2Hash> ChainedTable;
+typedef CommonUtils::FlatHashMap<std::string, unsigned int, CommonUtils::StringHash, std::equal_to<>> FlatTable;
+
+inline void Prepare(ChainedTable& table, size_t num_keys) { table.Init(static_cast<unsigned int>(num_keys)); }
+inline void Prepare(FlatTable& table, size_t num_keys) { table.Reserve(num_keys); }
+
+inline void Insert(ChainedTable& table, const char* key, unsigned int value) { table.Insert(key, value); }
+inline void Insert(FlatTable& table, const char* key, unsigned int value) { table.Insert(key, value); }
+
+inline bool Find(ChainedTable& table, const char* key, unsigned int& value) { return table.Find(key, &value); }
+inline bool Find(FlatTable& table, const char* key, unsigned int& value) {
+    const unsigned int* found = table.Find(key);
+    if(found) {
+        value = *found;
+    }
+    return found != nullptr;
+}
+
+//insert `keys`, then look them up in the order of `lookup_keys` and as many names that are not in the table,
+//by `const char*` as `Shader` does
+template<typename Table>
+void RunHashTablePhases(const std::string& table_name, const std::vector<std::string>& keys,
+                        const std::vector<std::string>& lookup_keys, const std::vector<std::string>& missing_keys, bool b_record, HashTableCase& hash_case) {
+    const std::string names[3] = {table_name + " insert", table_name + " find hit", table_name + " find miss"};
+    for(const auto& name : names) {
+        if(std::none_of(hash_case.phases.begin(), hash_case.phases.end(),
+                        [&name](const PhaseSamples& phase) { return phase.name == name; })) {
+            hash_case.phases.emplace_back(PhaseSamples{name, {}});
+        }
+    }
+    auto record = [&](const std::string& name, double seconds) {
+        if(b_record) {
+            std::find_if(hash_case.phases.begin(), hash_case.phases.end(),
+                         [&name](const PhaseSamples& phase) { return phase.name == name; })->seconds.emplace_back(seconds);
+        }
+    };
+
+    Table table;
+    Prepare(table, keys.size());
+    CommonUtils::Timer timer;
+    for(size_t i = 0 ; i < keys.size() ; i++) {
+        Insert(table, keys[i].c_str(), static_cast<unsigned int>(i));
+    }
+    record(names[0], timer.ElapsedSeconds());
+
+    size_t num_found = 0;
+    unsigned int value = 0, checksum = 0;
+    timer = CommonUtils::Timer();
+    for(const auto& key : lookup_keys) {
+        num_found += Find(table, key.c_str(), value);
+        checksum += value;
+    }
+    record(names[1], timer.ElapsedSeconds());
+    timer = CommonUtils::Timer();
+    for(const auto& key : missing_keys) {
+        num_found += Find(table, key.c_str(), value);
+    }
+    record(names[2], timer.ElapsedSeconds());
+    //the chained table compares hashes only, so a collision of names shows up here
+    if(num_found != keys.size() || checksum != keys.size() * (keys.size() - 1) / 2) {
+        std::cout<<table_name<<": "<<num_found<<" of "<<keys.size()<<" keys found\n";
+    }
+}
+
+HashTableCase RunHashTableCase(size_t num_keys, const Options& options) {
+    HashTableCase hash_case;
+    hash_case.num_keys = num_keys;
+    std::vector<std::string> keys(num_keys), missing_keys(num_keys);
+    for(size_t i = 0 ; i < num_keys ; i++) {
+        keys[i] = "uniformName" + std::to_string(i);
+        missing_keys[i] = "missingName" + std::to_string(i);
+    }
+    //not in insertion order, which is also the order of the chained entries in memory
+    std::vector<std::string> lookup_keys = keys;
+    std::mt19937 random(1);
+    std::shuffle(lookup_keys.begin(), lookup_keys.end(), random);
+    for(int i = 0 ; i < options.num_warmup + options.num_repetitions ; i++) {
+        const bool b_record = i >= options.num_warmup;
+        RunHashTablePhases<ChainedTable>("HashTable", keys, lookup_keys, missing_keys, b_record, hash_case);
+        RunHashTablePhases<FlatTable>("FlatHashMap", keys, lookup_keys, missing_keys, b_record, hash_case);
+    }
+    return hash_case;
+}
+
+inline double MegabytesPerSecond(size_t num_bytes, double seconds) {
+    return seconds > 0.0 ? num_bytes / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+void PrintLoaderCase(const LoaderCase& loader_case, size_t num_threads) {
+    std::cout<<loader_case.mesh_name<<" | load ("<<std::fixed<<std::setprecision(2)
+             <<loader_case.num_bytes / (1024.0 * 1024.0)<<" MB, "<<num_threads<<" threads)\n";
+    std::cout<<"  "<<std::left<<std::setw(26)<<"loader"<<std::right<<std::setw(14)<<"median (ms)"
+             <<std::setw(14)<<"MB/s"<<"\n";
+    for(const auto& loader : loader_case.loaders) {
+        const Statistics stats = ComputeStatistics(loader.seconds);
+        std::cout<<"  "<<std::left<<std::setw(26)<<loader.name<<std::right<<std::fixed<<std::setprecision(3)
+                 <<std::setw(14)<<stats.median * 1e3<<std::setprecision(1)
+                 <<std::setw(14)<<MegabytesPerSecond(loader_case.num_bytes, stats.median)<<"\n";
+    }
+}
+
+void PrintHashTableCase(const HashTableCase& hash_case) {
+    std::cout<<"hash tables | "<<hash_case.num_keys<<" string keys\n";
+    std::cout<<"  "<<std::left<<std::setw(26)<<"operation"<<std::right<<std::setw(14)<<"median (ms)"
+             <<std::setw(14)<<"ns/op"<<"\n";
+    for(const auto& phase : hash_case.phases) {
+        const Statistics stats = ComputeStatistics(phase.seconds);
+        std::cout<<"  "<<std::left<<std::setw(26)<<phase.name<<std::right<<std::fixed<<std::setprecision(3)
+                 <<std::setw(14)<<stats.median * 1e3<<std::setprecision(1)
+                 <<std::setw(14)<<stats.median * 1e9 / hash_case.num_keys<<"\n";
+    }
+}
+
+void PrintCase(const BenchmarkCase& benchmark_case) {
+    std::cout<<benchmark_case.mesh_name<<" | "<<SubDivision::MethodName(benchmark_case.method)
+             <<" | level "<<benchmark_case.level<<" ("<<benchmark_case.num_vertices<<" vertices, "
+             <<benchmark_case.num_polygons<<" polygons)\n";
+    std::cout<<"  "<<std::left<<std::setw(26)<<"phase"<<std::right<<std::setw(14)<<"median (ms)"
+             <<std::setw(14)<<"p95 (ms)"<<"\n";
+    for(const auto& phase : benchmark_case.phases) {
+        const Statistics stats = ComputeStatistics(phase.seconds);
+        std::cout<<"  "<<std::left<<std::setw(26)<<phase.name<<std::right<<std::fixed<<std::setprecision(3)
+                 <<std::setw(14)<<stats.median * 1e3<<std::setw(14)<<stats.p95 * 1e3<<"\n";
+    }
+}
+
+std::string JsonString(const std::string& str) {
+    std::string res = "\"";
+    for(const char c : str) {
+        if(c == '"' || c == '\\') {
+            res += '\\';
+        }
+        res += c;
+    }
+    return res + "\"";
+}
+
+bool WriteJson(const std::string& json_path, const Options& options,
+               const std::vector<LoaderCase>& loader_cases,
+               const std::vector<BenchmarkCase>& benchmark_cases,
+               const std::vector<HashTableCase>& hash_cases) {
+    std::ofstream file(json_path);
+    if(!file.is_open()) {
+        std::cerr << "fail to open file " + json_path << std::endl;
+        return false;
+    }
+#ifdef NDEBUG
+    const char* build_type = "release";
+#else
+    const char* build_type = "debug";
+#endif
+    file<<std::setprecision(9);
+    file<<"{\n";
+    file<<"  \"compiler\": "<<JsonString(__VERSION__)<<",\n";
+    file<<"  \"build\": \""<<build_type<<"\",\n";
+    file<<"  \"warmup\": "<<options.num_warmup<<",\n";
+    file<<"  \"repetitions\": "<<options.num_repetitions<<",\n";
+    file<<"  \"loaders\": [";
+    bool b_first = true;
+    for(const auto& loader_case : loader_cases) {
+        for(const auto& loader : loader_case.loaders) {
+            const Statistics stats = ComputeStatistics(loader.seconds);
+            file<<(b_first ? "\n" : ",\n");
+            b_first = false;
+            file<<"    {\"mesh\": "<<JsonString(loader_case.mesh_name)
+                <<", \"loader\": "<<JsonString(loader.name)
+                <<", \"bytes\": "<<loader_case.num_bytes
+                <<", \"min_ms\": "<<stats.min * 1e3
+                <<", \"median_ms\": "<<stats.median * 1e3
+                <<", \"p95_ms\": "<<stats.p95 * 1e3
+                <<", \"mb_per_s\": "<<MegabytesPerSecond(loader_case.num_bytes, stats.median)<<"}";
+        }
+    }
+    file<<"\n  ],\n";
+    file<<"  \"results\": [";
+    b_first = true;
+    for(const auto& benchmark_case : benchmark_cases) {
+        for(const auto& phase : benchmark_case.phases) {
+            const Statistics stats = ComputeStatistics(phase.seconds);
+            file<<(b_first ? "\n" : ",\n");
+            b_first = false;
+            file<<"    {\"mesh\": "<<JsonString(benchmark_case.mesh_name)
+                <<", \"method\": "<<JsonString(SubDivision::MethodName(benchmark_case.method))
+                <<", \"level\": "<<benchmark_case.level
+                <<", \"vertices\": "<<benchmark_case.num_vertices
+                <<", \"edges\": "<<benchmark_case.num_edges
+                <<", \"polygons\": "<<benchmark_case.num_polygons
+                <<", \"phase\": "<<JsonString(phase.name)
+                <<", \"min_ms\": "<<stats.min * 1e3
+                <<", \"mean_ms\": "<<stats.mean * 1e3
+                <<", \"median_ms\": "<<stats.median * 1e3
+                <<", \"p95_ms\": "<<stats.p95 * 1e3<<"}";
+        }
+    }
+    file<<"\n  ],\n";
+    file<<"  \"hash_tables\": [";
+    b_first = true;
+    for(const auto& hash_case : hash_cases) {
+        for(const auto& phase : hash_case.phases) {
+            const Statistics stats = ComputeStatistics(phase.seconds);
+            file<<(b_first ? "\n" : ",\n");
+            b_first = false;
+            file<<"    {\"keys\": "<<hash_case.num_keys
+                <<", \"operation\": "<<JsonString(phase.name)
+                <<", \"min_ms\": "<<stats.min * 1e3
+                <<", \"median_ms\": "<<stats.median * 1e3
+                <<", \"ns_per_op\": "<<stats.median * 1e9 / hash_case.num_keys<<"}";
+        }
+    }
+    file<<"\n  ]\n}\n";
+    return file.good();
+}
+
+void PrintUsage() {
+    std::cout<<"Please enter benchmarkSubdivisionSurface [-m loop,catmull,doo] [-l levels] [-w warmup] "
+             <<"[-r repetitions] [-t threads] [-j result.json] [-H] [obj_path|ply_path|gen:<name>:<num_faces>[:<param>]]...\n"
+             <<"generators: grid, torus, icosphere, random (param: seed), holes (param: hole size), pole (param: valence)\n"
+             <<"-H: time the shader uniform map against the old chained hash table, meshes are then optional\n";
+}
+
+bool ParseArguments(int argc, const char* argv[], Options& options) {
+    for(int i = 1 ; i < argc ; i++) {
+        const bool b_has_value = i + 1 < argc;
+        if(std::strcmp(argv[i], "-m") == 0 && b_has_value) {
+            std::stringstream ss(argv[++i]);
+            std::string name;
+            while(std::getline(ss, name, ',')) {
+                SubDivision::SubdivisionMethod method;
+                if(!SubDivision::ParseMethod(name, method)) {
+                    std::cout<<"Unknown subdivision method "<<name<<"\n";
+                    return false;
+                }
+                options.methods.emplace_back(method);
+            }
+        } else if(std::strcmp(argv[i], "-l") == 0 && b_has_value) {
+            options.num_levels = std::atoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-w") == 0 && b_has_value) {
+            options.num_warmup = std::atoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-r") == 0 && b_has_value) {
+            options.num_repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if(std::strcmp(argv[i], "-t") == 0 && b_has_value) {
+            options.num_threads = std::atoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-j") == 0 && b_has_value) {
+            options.json_path = argv[++i];
+        } else if(std::strcmp(argv[i], "-H") == 0) {
+            options.b_hash_tables = true;
+        } else if(argv[i][0] == '-') {
+            return false;
+        } else {
+            options.input_paths.emplace_back(argv[i]);
+        }
+    }
+    if(options.methods.empty()) {
+        options.methods = {SubDivision::kLoop, SubDivision::kCatmullClark, SubDivision::kDooSabin};
+    }
+    return !options.input_paths.empty() || options.b_hash_tables;
+}
+
+//`input_path` is an obj or ply file or a generator spec `gen:<name>:<num_faces>[:<param>]`
+bool LoadInput(const std::string& input_path, SubDivision::SubdivisionMethod method, CommonUtils::ThreadPool& pool,
+               std::vector<Eigen::Vector3d>& vertices, std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices) {
+    const bool b_triangulate = SubDivision::RequiresTriangles(method);
+    if(SubDivision::MeshGenerator::IsSpec(input_path)) {
+        return SubDivision::MeshGenerator::Generate(input_path, vertices, face_offsets, face_indices, b_triangulate);
+    }
+    return CommonUtils::LoadMeshFile(input_path, vertices, face_offsets, face_indices, b_triangulate, &pool);
+}
+
+int main(int argc, const char* argv[]){
+    Options options;
+    if(!ParseArguments(argc, argv, options)) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<HashTableCase> hash_cases;
+    if(options.b_hash_tables) {
+        for(const size_t num_keys : {16, 256, 4096, 65536}) {
+            hash_cases.emplace_back(RunHashTableCase(num_keys, options));
+            PrintHashTableCase(hash_cases.back());
+        }
+    }
+
+    CommonUtils::ThreadPool pool(options.num_threads);
+    //an input that fails to load is skipped, the other inputs and the JSON are still written
+    std::set<std::string> failed_paths;
+    std::vector<LoaderCase> loader_cases;
+    for(const auto& input_path : options.input_paths) {
+        if(!SubDivision::MeshGenerator::IsSpec(input_path)) {
+            LoaderCase loader_case;
+            if(!RunLoaderCase(input_path, options, pool, loader_case)) {
+                failed_paths.insert(input_path);
+                continue;
+            }
+            loader_cases.emplace_back(std::move(loader_case));
+            PrintLoaderCase(loader_cases.back(), pool.NumThreads());
+        }
+    }
+
+    std::vector<BenchmarkCase> benchmark_cases;
+    for(const auto& input_path : options.input_paths) {
+        if(failed_paths.count(input_path)) {
+            continue;
+        }
+        const std::string mesh_name = SubDivision::MeshGenerator::IsSpec(input_path) ?
+                                      input_path : std::filesystem::path(input_path).stem().string();
+        for(const auto method : options.methods) {
+            std::vector<Eigen::Vector3d> vertices;
+            std::vector<index_t> face_offsets, face_indices;
+            if(!LoadInput(input_path, method, pool, vertices, face_offsets, face_indices)) {
+                failed_paths.insert(input_path);
+                break;
+            }
+            std::unique_ptr<Mesh> mesh(new Mesh());
+            mesh->SetUp(vertices, face_offsets, face_indices);
+            for(int level = 0 ; level < options.num_levels ; level++) {
+                std::unique_ptr<Mesh> updated_mesh;
+                benchmark_cases.emplace_back(RunCase(mesh_name, method, level, *mesh, options, pool, updated_mesh));
+                PrintCase(benchmark_cases.back());
+                mesh = std::move(updated_mesh);
+            }
+        }
+    }
+
+    if(!options.json_path.empty() && !WriteJson(options.json_path, options, loader_cases, benchmark_cases, hash_cases)) {
+        return 1;
+    }
+    return failed_paths.empty() ? 0 : 1;
+}
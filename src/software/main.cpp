@@ -12,8 +12,8 @@ void Run(const CommonUtils::Config& config) {
 
 
 int main(int argc, const char* argv[]){
-    if(argc != 4) {
-        std::cout<<"Please enter mainSubdivisionSurface [obj_path] [vertex_shader_path] [fragment_shader_path]\n";
+    if(argc != 4 && argc != 5) {
+        std::cout<<"Please enter mainSubdivisionSurface [obj_path] [vertex_shader_path] [fragment_shader_path] [frame_log.csv (optional)]\n";
         return 0;
     }
 
@@ -23,6 +23,10 @@ int main(int argc, const char* argv[]){
     config.vertex_shader_path = argv[2];
     config.fragment_shader_path = argv[3];
     config.maximum_level = 3;
+    if(argc == 5) {
+        config.frame_log_path = argv[4];
+        config.continuous_rendering = true;  //a frame log of an idle window would be empty
+    }
     Run(config);
     //test3dOrdering();
 }
\ No newline at end of file
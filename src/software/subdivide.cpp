@@ -0,0 +1,226 @@
+#include "subdivision/batch_subdivision.h"
+#include "subdivision/mesh_generator.h"
+#include "subdivision/mesh_writer.h"
+#include "subdivision/smesh_io.h"
+#include "utils/io_utils.h"
+#include "utils/obj_parser.h"
+#include "utils/vertex_weld.h"
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+
+struct Options {
+    std::string input_path;
+    std::string output_path;
+    SubDivision::SubdivisionMethod method = SubDivision::kCatmullClark;
+    int num_levels = 1;
+    size_t num_threads = 0;
+    bool b_print_stats = false;
+    bool b_texcoords = false;
+    double weld_tolerance = -1.0;  //< 0: vertices are not welded
+};
+
+void PrintUsage() {
+    std::cout<<"Please enter subdivide -i [obj_path|ply_path|smesh_path|mesh_dir|list.txt|gen:<name>:<num_faces>[:<param>]] [-s loop|catmull|doo] [-l levels] "
+             <<"[-t threads] [-o output_path|output_dir] [-v] [-uv] [-w tolerance]\n"
+             <<"the output format follows the extension: *.obj, binary *.ply, or *.smesh which keeps every level\n"
+             <<"with its topology, an input *.smesh continues from its finest level\n"
+             <<"-v prints the statistics of every subdivision step\n"
+             <<"-uv refines the texture coordinates of an obj input (face-varying) and writes them to an obj output\n"
+             <<"-w merges the loaded vertices closer than tolerance (0: identical positions) and drops degenerate polygons\n";
+}
+
+bool ParseArguments(int argc, const char* argv[], Options& options) {
+    for(int i = 1 ; i < argc ; i++) {
+        const bool b_has_value = i + 1 < argc;
+        if(std::strcmp(argv[i], "-i") == 0 && b_has_value) {
+            options.input_path = argv[++i];
+        } else if(std::strcmp(argv[i], "-o") == 0 && b_has_value) {
+            options.output_path = argv[++i];
+        } else if(std::strcmp(argv[i], "-s") == 0 && b_has_value) {
+            if(!SubDivision::ParseMethod(argv[++i], options.method)) {
+                std::cout<<"Unknown subdivision scheme "<<argv[i]<<"\n";
+                return false;
+            }
+        } else if(std::strcmp(argv[i], "-l") == 0 && b_has_value) {
+            options.num_levels = std::atoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-t") == 0 && b_has_value) {
+            options.num_threads = std::atoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-v") == 0) {
+            options.b_print_stats = true;
+        } else if(std::strcmp(argv[i], "-uv") == 0) {
+            options.b_texcoords = true;
+        } else if(std::strcmp(argv[i], "-w") == 0 && b_has_value) {
+            options.weld_tolerance = std::atof(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return !options.input_path.empty();
+}
+
+void PrintPhases(const std::vector<std::pair<std::string, double>>& phases) {
+    double total_seconds = 0.0;
+    std::cout<<std::left<<std::setw(24)<<"phase"<<std::right<<std::setw(12)<<"time (ms)"<<"\n";
+    for(const auto& phase : phases) {
+        std::cout<<std::left<<std::setw(24)<<phase.first<<std::right<<std::setw(12)
+                 <<std::fixed<<std::setprecision(3)<<phase.second * 1e3<<"\n";
+        total_seconds += phase.second;
+    }
+    std::cout<<std::left<<std::setw(24)<<"total"<<std::right<<std::setw(12)
+             <<std::fixed<<std::setprecision(3)<<total_seconds * 1e3<<"\n";
+}
+
+//many meshes: hand them to the batch engine, `output_path` is a directory
+int RunBatch(const Options& options, CommonUtils::ThreadPool& pool) {
+    SubDivision::BatchOptions batch_options;
+    batch_options.method = options.method;
+    batch_options.num_levels = options.num_levels;
+    batch_options.output_dir = options.output_path;
+    batch_options.weld_tolerance = options.weld_tolerance;
+    SubDivision::BatchSubdivision batch(batch_options);
+    if(!batch.AddPath(options.input_path)) {
+        return 1;
+    }
+    const bool b_success = batch.Run(pool);
+    batch.PrintSummary();
+    return b_success ? 0 : 1;
+}
+
+int RunSingle(const Options& options, CommonUtils::ThreadPool& pool) {
+    std::vector<std::pair<std::string, double>> phases;
+    CommonUtils::Timer timer;
+
+    std::vector<Eigen::Vector3d> vertices;
+    std::vector<CommonUtils::index_t> face_offsets, face_indices;
+    const bool b_triangulate = SubDivision::RequiresTriangles(options.method);
+    const bool b_generated = SubDivision::MeshGenerator::IsSpec(options.input_path);
+    const bool b_smesh = SubDivision::IsSmeshPath(options.input_path);
+    SubDivision::SmeshFile smesh_file;
+    const bool b_texcoords = options.b_texcoords && std::filesystem::path(options.input_path).extension() == ".obj";
+    CommonUtils::TexCoordObjSink texcoord_sink(vertices, face_offsets, face_indices);
+    if(b_generated) {
+        if(!SubDivision::MeshGenerator::Generate(options.input_path, vertices, face_offsets, face_indices, b_triangulate)) {
+            return 1;
+        }
+        phases.emplace_back("generate", timer.ElapsedSeconds());
+    } else if(b_smesh) {
+        if(!smesh_file.Open(options.input_path) || smesh_file.NumLevels() == 0) {
+            return 1;
+        }
+        phases.emplace_back("map", timer.ElapsedSeconds());
+    } else if(b_texcoords) {
+        //`vt` ids are relative to the whole file, so this one is parsed on one thread
+        if(!CommonUtils::ParseObjFile(options.input_path, texcoord_sink, b_triangulate)) {
+            return 1;
+        }
+        phases.emplace_back("load", timer.ElapsedSeconds());
+    } else {
+        if(!CommonUtils::LoadMeshFile(options.input_path, vertices, face_offsets, face_indices, b_triangulate, &pool)) {
+            return 1;
+        }
+        phases.emplace_back("load", timer.ElapsedSeconds());
+    }
+    if(options.weld_tolerance >= 0.0 && !b_generated && !b_smesh) {
+        timer.Reset();
+        std::vector<CommonUtils::index_t> kept_corners;
+        const CommonUtils::WeldResult weld = CommonUtils::WeldVertices(vertices, face_offsets, face_indices,
+                                                                       options.weld_tolerance, &pool, &kept_corners);
+        auto& corner_texcoords = texcoord_sink.corner_texcoords;
+        if(!corner_texcoords.empty()) {
+            std::vector<CommonUtils::index_t> welded_texcoords(kept_corners.size());
+            for(size_t k = 0 ; k < kept_corners.size() ; k++) {
+                welded_texcoords[k] = corner_texcoords[kept_corners[k]];
+            }
+            corner_texcoords = std::move(welded_texcoords);
+        }
+        std::cout<<"weld: "<<weld.num_merged_vertices<<" vertices merged, "<<weld.num_unreferenced_vertices<<" unreferenced vertices removed, "<<weld.num_dropped_polygons<<" polygons dropped\n";
+        phases.emplace_back("weld", timer.ElapsedSeconds());
+    }
+
+    //every level is kept when a .smesh is written, otherwise only the finest one
+    const bool b_keep_levels = SubDivision::IsSmeshPath(options.output_path);
+    std::vector<std::unique_ptr<SubDivision::Mesh>> levels;
+    timer.Reset();
+    std::unique_ptr<SubDivision::Mesh> mesh(new SubDivision::Mesh());
+    if(b_smesh) {
+        //a pre-subdivided asset continues from its finest stored level
+        smesh_file.LoadLevel(smesh_file.NumLevels() - 1, *mesh);
+    } else {
+        mesh->SetUp(vertices, face_offsets, face_indices);
+    }
+    if(b_texcoords && texcoord_sink.HasTexCoords()) {
+        SubDivision::PrimvarChannel uv;
+        uv.name = "uv";
+        uv.width = 2;
+        uv.b_face_varying = true;
+        uv.values = std::move(texcoord_sink.texcoords);
+        uv.corner_indices = std::move(texcoord_sink.corner_texcoords);
+        mesh->AddPrimvar(std::move(uv));
+    } else if(b_texcoords) {
+        std::cout<<"Some corners have no texture coordinates, they are not refined\n";
+    }
+    phases.emplace_back("set up topology", timer.ElapsedSeconds());
+
+    std::unique_ptr<SubDivision::SubDivisionSolver> solver = SubDivision::CreateSolver(options.method);
+    std::vector<SubDivision::SubdivisionStats> level_stats;
+    for(int i = 1 ; i <= options.num_levels ; i++) {
+        timer.Reset();
+        std::unique_ptr<SubDivision::Mesh> updated_mesh(new SubDivision::Mesh());
+        SubDivision::SubdivisionStats stats;
+        if(!solver->Run(*mesh, *updated_mesh, &stats)) {
+            std::cout<<"Subdivision stops at level "<<i - 1<<"\n";
+            break;
+        }
+        if(b_keep_levels) {
+            levels.emplace_back(std::move(mesh));
+        }
+        mesh = std::move(updated_mesh);
+        phases.emplace_back("level " + std::to_string(i), timer.ElapsedSeconds());
+        level_stats.emplace_back(std::move(stats));
+    }
+
+    if(!options.output_path.empty()) {
+        timer.Reset();
+        if(b_keep_levels) {
+            std::vector<const SubDivision::Mesh*> level_ptrs;
+            for(const auto& level : levels) {
+                level_ptrs.emplace_back(level.get());
+            }
+            level_ptrs.emplace_back(mesh.get());
+            if(!SubDivision::SaveSmesh(options.output_path, level_ptrs)) {
+                return 1;
+            }
+        } else if(!SubDivision::WriteMesh(*mesh, options.output_path, &pool)) {
+            return 1;
+        }
+        phases.emplace_back("write", timer.ElapsedSeconds());
+    }
+
+    std::cout<<SubDivision::MethodName(options.method)<<": "<<mesh->Vertices().size()<<" vertices, "
+             <<mesh->Edges().size()<<" edges, "<<mesh->Polygons().size()<<" polygons, "
+             <<pool.NumThreads()<<" threads\n";
+    PrintPhases(phases);
+    if(options.b_print_stats) {
+        for(size_t i = 0 ; i < level_stats.size() ; i++) {
+            std::cout<<"\nlevel "<<i + 1<<"\n";
+            level_stats[i].Print();
+        }
+    }
+    return 0;
+}
+
+int main(int argc, const char* argv[]){
+    Options options;
+    if(!ParseArguments(argc, argv, options)) {
+        PrintUsage();
+        return 1;
+    }
+
+    CommonUtils::ThreadPool pool(options.num_threads);
+    const std::string extension = std::filesystem::path(options.input_path).extension().string();
+    if(std::filesystem::is_directory(options.input_path) || extension == ".txt" || extension == ".lst") {
+        return RunBatch(options, pool);
+    }
+    return RunSingle(options, pool);
+}
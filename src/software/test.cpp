@@ -59,7 +59,7 @@ int testRendering( const CommonUtils::Config& config) {
         -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f, 0.7f, 0.6f, 0.6f
     };
     viewer.SetUp(800, 600, config.vertex_shader_path, config.fragment_shader_path, config);
-    viewer.CreateMeshPNC(vertices, 9, 36, glm::vec3(0.4, 0.4, 0.0), glm::mat4(1.0));
+    viewer.CreateMeshPNC(0, vertices, 9, 36, glm::vec3(0.4, 0.4, 0.0), glm::mat4(1.0));
     viewer.Run();
     return 0;
 }
@@ -80,7 +80,7 @@ int testModel( const CommonUtils::Config& config){
 
     GLRendering::Viewer& viewer =  GLRendering::Viewer::Instance();
     viewer.SetUp(scr_width, scr_height, config.vertex_shader_path, config.fragment_shader_path, config);
-    viewer.CreateMeshPNC(vertices->data(), 9, num_vertex, glm::vec3(0.4, 0.4, 0.0) ,glm::mat4(1.0));
+    viewer.CreateMeshPNC(0, vertices->data(), 9, num_vertex, glm::vec3(0.4, 0.4, 0.0) ,glm::mat4(1.0));
     viewer.Run();
     return 0;
 }
@@ -127,7 +127,7 @@ int solve( const CommonUtils::Config& config) {
             size_t num_vertex;
             std::tie(pData, num_vertex) = meshes[i].ConvertToTriangularMesh();
             std::cout<<i<<" pData->size(): "<<pData.size()<<"\n";
-            viewer.CreateMeshPNC(pData.data(), 9, num_vertex, glm::vec3(0.4, 0.4, 0.0) ,glm::mat4(1.0));
+            viewer.CreateMeshPNC(i, pData.data(), 9, num_vertex, glm::vec3(0.4, 0.4, 0.0) ,glm::mat4(1.0));
         }
         viewer.Run();
     }
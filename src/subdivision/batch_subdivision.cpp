@@ -0,0 +1,203 @@
+#include "batch_subdivision.h"
+#include "mesh_writer.h"
+#include "utils/io_utils.h"
+#include "utils/vertex_weld.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace SubDivision {
+
+    namespace fs = std::filesystem;
+
+    struct BatchSubdivision::Job {
+        size_t index;
+        std::vector<Eigen::Vector3d> vertices;
+        std::vector<index_t> face_offsets;  //polygons as compressed rows
+        std::vector<index_t> face_indices;
+        std::unique_ptr<Mesh> mesh;
+        CommonUtils::Timer timer;
+    };
+
+    BatchSubdivision::BatchSubdivision(const BatchOptions& options)
+        : options_(options)
+        , pool_(nullptr)
+        , seconds_(0.0) {
+    }
+
+    void BatchSubdivision::AddFile(const std::string& file_path) {
+        input_paths_.emplace_back(file_path);
+    }
+
+    bool BatchSubdivision::AddDirectory(const std::string& dir_path) {
+        std::error_code error;
+        fs::directory_iterator it(dir_path, error);
+        if(error) {
+            std::cerr << "fail to open directory " + dir_path << std::endl;
+            return false;
+        }
+        std::vector<std::string> file_paths;
+        for(const auto& entry : it) {
+            if(entry.is_regular_file() &&
+               (entry.path().extension() == ".obj" || entry.path().extension() == ".ply")) {
+                file_paths.emplace_back(entry.path().string());
+            }
+        }
+        std::sort(file_paths.begin(), file_paths.end());
+        input_paths_.insert(input_paths_.end(), file_paths.begin(), file_paths.end());
+        return true;
+    }
+
+    bool BatchSubdivision::AddList(const std::string& list_path) {
+        std::ifstream file(list_path);
+        if(!file.is_open()) {
+            std::cerr << "fail to open file " + list_path << std::endl;
+            return false;
+        }
+        std::string line;
+        while(std::getline(file, line)) {
+            if(!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if(line.empty() || line[0] == '#') {
+                continue;
+            }
+            input_paths_.emplace_back(line);
+        }
+        return true;
+    }
+
+    bool BatchSubdivision::AddPath(const std::string& path) {
+        if(fs::is_directory(path)) {
+            return AddDirectory(path);
+        }
+        const std::string extension = fs::path(path).extension().string();
+        if(extension == ".txt" || extension == ".lst") {
+            return AddList(path);
+        }
+        AddFile(path);
+        return true;
+    }
+
+    bool BatchSubdivision::Run() {
+        CommonUtils::ThreadPool pool(options_.num_threads);
+        return Run(pool);
+    }
+
+    bool BatchSubdivision::Run(CommonUtils::ThreadPool& pool) {
+        if(!options_.output_dir.empty()) {
+            std::error_code error;
+            fs::create_directories(options_.output_dir, error);
+            if(error) {
+                std::cerr << "fail to create directory " + options_.output_dir << std::endl;
+                return false;
+            }
+        }
+
+        pool_ = &pool;
+        results_.assign(input_paths_.size(), BatchResult());
+        CommonUtils::Timer timer;
+        for(size_t i = 0 ; i < input_paths_.size() ; i++) {
+            auto job = std::make_shared<Job>();
+            job->index = i;
+            results_[i].input_path = input_paths_[i];
+            pool.Submit([this, job]() { LoadStage(job); });
+        }
+        pool.Wait();
+        seconds_ = timer.ElapsedSeconds();
+        pool_ = nullptr;
+        return NumSucceeded() == input_paths_.size();
+    }
+
+    void BatchSubdivision::LoadStage(const std::shared_ptr<Job>& job) {
+        job->timer.Reset();
+        const std::string& input_path = input_paths_[job->index];
+        if(!CommonUtils::LoadMeshFile(input_path, job->vertices, job->face_offsets, job->face_indices,
+                                      RequiresTriangles(options_.method), pool_)) {
+            Finish(job, false);
+            return;
+        }
+        if(options_.weld_tolerance >= 0.0) {
+            CommonUtils::WeldVertices(job->vertices, job->face_offsets, job->face_indices, options_.weld_tolerance, pool_);
+        }
+        results_[job->index].num_input_polygons = job->face_offsets.size() - 1;
+        pool_->Submit([this, job]() { SubdivideStage(job); });
+    }
+
+    void BatchSubdivision::SubdivideStage(const std::shared_ptr<Job>& job) {
+        job->mesh.reset(new Mesh());
+        job->mesh->SetUp(job->vertices, job->face_offsets, job->face_indices);
+        job->vertices = std::vector<Eigen::Vector3d>();
+        job->face_offsets = std::vector<index_t>();
+        job->face_indices = std::vector<index_t>();
+
+        std::unique_ptr<SubDivisionSolver> solver = CreateSolver(options_.method);
+        BatchResult& result = results_[job->index];
+        int num_levels = 0;
+        for(int i = 0 ; i < options_.num_levels ; i++) {
+            std::unique_ptr<Mesh> updated_mesh(new Mesh());
+            SubdivisionStats stats;
+            if(!solver->Run(*job->mesh, *updated_mesh, &stats)) {
+                break;
+            }
+            result.level_stats.emplace_back(std::move(stats));
+            job->mesh = std::move(updated_mesh);
+            num_levels++;
+        }
+        result.num_levels = num_levels;
+        result.num_output_polygons = job->mesh->Polygons().size();
+
+        if(options_.output_dir.empty()) {
+            Finish(job, true);
+            return;
+        }
+        pool_->Submit([this, job]() { WriteStage(job); });
+    }
+
+    void BatchSubdivision::WriteStage(const std::shared_ptr<Job>& job) {
+        BatchResult& result = results_[job->index];
+        result.output_path = OutputPath(result.input_path);
+        Finish(job, WriteMesh(*job->mesh, result.output_path, pool_));
+    }
+
+    void BatchSubdivision::Finish(const std::shared_ptr<Job>& job, bool b_success) {
+        BatchResult& result = results_[job->index];
+        result.b_success = b_success;
+        result.seconds = job->timer.ElapsedSeconds();
+        if(verbose) {
+            std::cout << "finish " << result.input_path << " (" << result.num_levels << " levels, "
+                      << result.num_output_polygons << " polygons) in " << result.seconds << " s\n";
+        }
+    }
+
+    std::string BatchSubdivision::OutputPath(const std::string& input_path) const {
+        static const char* method_keys[] = {"loop", "catmull", "doo"};
+        const std::string file_name = fs::path(input_path).stem().string() + "_" + method_keys[options_.method] +
+                                      "_l" + std::to_string(options_.num_levels) + options_.output_extension;
+        return (fs::path(options_.output_dir) / file_name).string();
+    }
+
+    size_t BatchSubdivision::NumSucceeded() const {
+        return std::count_if(results_.begin(), results_.end(),
+                             [](const BatchResult& result) { return result.b_success; });
+    }
+
+    double BatchSubdivision::MeshesPerSecond() const {
+        return seconds_ > 0.0 ? NumSucceeded() / seconds_ : 0.0;
+    }
+
+    void BatchSubdivision::PrintSummary() const {
+        size_t num_output_polygons = 0;
+        for(const auto& result : results_) {
+            if(!result.b_success) {
+                std::cout << "failed: " << result.input_path << "\n";
+                continue;
+            }
+            num_output_polygons += result.num_output_polygons;
+        }
+        std::cout << MethodName(options_.method) << ", " << options_.num_levels << " levels\n";
+        std::cout << "meshes: " << NumSucceeded() << " / " << results_.size()
+                  << ", output polygons: " << num_output_polygons << "\n";
+        std::cout << "time: " << seconds_ << " s, " << MeshesPerSecond() << " meshes/s\n";
+    }
+}
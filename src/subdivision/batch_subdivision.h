@@ -0,0 +1,67 @@
+#pragma once
+#include "solver_factory.h"
+#include "utils/thread_pool.h"
+#include <string>
+#include <vector>
+
+namespace SubDivision {
+
+    struct BatchOptions {
+        SubdivisionMethod method = kCatmullClark;
+        int num_levels = 1;  //number of subdivision steps applied to every mesh
+        size_t num_threads = 0;  //used by `Run()` without a pool, 0: hardware concurrency
+        std::string output_dir;  //refined meshes are not written if empty
+        std::string output_extension = ".obj";  //.obj or .ply, see `WriteMesh`
+        double weld_tolerance = -1.0;  //>= 0: loaded vertices are welded, see `WeldVertices`
+    };
+
+    struct BatchResult {
+        std::string input_path;
+        std::string output_path;
+        bool b_success = false;
+        int num_levels = 0;  //levels actually reached, a solver may stop early
+        size_t num_input_polygons = 0;
+        size_t num_output_polygons = 0;
+        double seconds = 0.0;  //load + subdivide + write of this mesh
+        std::vector<SubdivisionStats> level_stats;  //level_stats[i]: step from level i to i + 1
+    };
+
+    //Subdivide many meshes concurrently. Every mesh is a chain of three tasks
+    //`load -> subdivide -> write`, each stage submits its successor to the pool, so the
+    //successor usually runs on the same worker while idle workers steal other meshes.
+    class BatchSubdivision {
+    public:
+        explicit BatchSubdivision(const BatchOptions& options);
+
+        void AddFile(const std::string& file_path);
+        bool AddDirectory(const std::string& dir_path);  //every *.obj and *.ply inside the directory
+        bool AddList(const std::string& list_path);  //one mesh path per line
+        bool AddPath(const std::string& path);  //directory, list (*.txt, *.lst) or mesh file
+
+        bool Run();
+        bool Run(CommonUtils::ThreadPool& pool);
+
+        inline size_t NumJobs() const { return input_paths_.size(); }
+        inline const std::vector<BatchResult>& Results() const { return results_; }
+        size_t NumSucceeded() const;
+        inline double Seconds() const { return seconds_; }
+        double MeshesPerSecond() const;
+        void PrintSummary() const;
+
+    private:
+        struct Job;
+
+        void LoadStage(const std::shared_ptr<Job>& job);
+        void SubdivideStage(const std::shared_ptr<Job>& job);
+        void WriteStage(const std::shared_ptr<Job>& job);
+        void Finish(const std::shared_ptr<Job>& job, bool b_success);
+        std::string OutputPath(const std::string& input_path) const;
+
+        BatchOptions options_;
+        std::vector<std::string> input_paths_;
+        std::vector<BatchResult> results_;  //results_[i] <-> input_paths_[i]
+        CommonUtils::ThreadPool* pool_;
+        double seconds_;
+        const bool verbose = false;
+    };
+}
@@ -1,8 +1,14 @@
 #include "catmull_solver.h"
 namespace SubDivision {
-    bool CatmullClarkSolver::Run(const Mesh& mesh, Mesh& updated_mesh) {
+    bool CatmullClarkSolver::Run(const Mesh& mesh, Mesh& updated_mesh, SubdivisionStats* stats) {
+        ResetPointTable();
+        BeginPrimvars(mesh);
+        BeginStats(mesh, 4, stats);
+        CommonUtils::Timer timer;
         std::vector<Eigen::Vector3d> edge_points = GetEdgePoints(mesh);  //mesh.edges <-> edge_points (index consistence)
+        RecordPhase("edge points", timer, stats);
         std::vector<Eigen::Vector3d> face_points = GetFacePoints(mesh);  //mesh.polygons <-> face_points (index consistence)
+        RecordPhase("face points", timer, stats);
         std::vector<index_t> updated_face_points;  //mesh.polygons <-> updated_face_points (index consistence)
         std::vector<index_t> updated_edge_points; //mesh.edges <-> updated_edge_points (index consistence)
         std::vector<index_t> updated_vertices; //mesh.vertices <-> updated_vertices (index consistence)
@@ -16,12 +22,14 @@ namespace SubDivision {
         
 
 
-        UpdateFacePoints(face_points, updated_face_points);
+        UpdateFacePoints(mesh, face_points, updated_face_points);
+        RecordPhase("update face points", timer, stats);
         if(verbose) {
             std::cout<<"UpdateFacePoints:\n";
             PrintPointTable();
         }
         UpdateEdgePoints(mesh, face_points, updated_edge_points);
+        RecordPhase("update edge points", timer, stats);
         if(verbose) {
             std::cout<<"UpdateEdgePoints:\n";
             PrintPointTable();
@@ -29,11 +37,13 @@ namespace SubDivision {
         if(!UpdateVertices(mesh, face_points, edge_points, updated_vertices)) {
             return false;
         }
+        RecordPhase("update vertices", timer, stats);
         if(verbose) {
             std::cout<<"UpdateVertices:\n";
             PrintPointTable();
         }
         Divide(mesh, updated_face_points, updated_edge_points, updated_vertices, polygons);
+        RecordPhase("divide", timer, stats);
         if(verbose) {
             std::cout<<"Divide:\n";
             for(int i = 0 ; i < polygons.size() ; i++) {
@@ -45,6 +55,13 @@ namespace SubDivision {
             }
         }
         MakeUpMesh(polygons, updated_mesh);
+        RecordPhase("make up mesh", timer, stats);
+        if(RefinesPrimvars()) {
+            RefinePrimvars(mesh, updated_mesh);
+            RecordPhase("primvars", timer, stats);
+        }
+        EndStats(updated_mesh, VectorBytes(edge_points) + VectorBytes(face_points) + VectorBytes(updated_face_points) +
+                 VectorBytes(updated_edge_points) + VectorBytes(updated_vertices) + VectorBytes(polygons), stats);
         if(verbose) {
             std::cout<<"MakeUpMesh:\n";
             for(int i = 0 ; i < polygons.size() ; i++) {
@@ -58,11 +75,21 @@ namespace SubDivision {
         return true;
     }
 
-    void CatmullClarkSolver::UpdateFacePoints(const std::vector<Eigen::Vector3d>& face_points,
+    void CatmullClarkSolver::UpdateFacePoints(const Mesh& mesh, const std::vector<Eigen::Vector3d>& face_points,
                                             std::vector<index_t>& updated_face_points)   {
         updated_face_points.resize(face_points.size());
         for(int i = 0; i < face_points.size() ; i++) {
-            updated_face_points[i] = CreatePoint(face_points[i]);
+            updated_face_points[i] = CreatePoint(face_points[i], {PointOrigin::kFace, i});
+            if(RefinesPrimvars()) {
+                AddFaceStencil(mesh, i, 1.0);
+            }
+        }
+    }
+
+    void CatmullClarkSolver::AddFaceStencil(const Mesh& mesh, index_t polygon_id, double weight) {
+        const auto& points = mesh.PolygonElement(polygon_id)->points;
+        for(const auto& vertex_id : points) {
+            AddStencil(vertex_id, weight / points.size());
         }
     }
 
@@ -78,14 +105,23 @@ namespace SubDivision {
             const std::vector<index_t>& asso_polygons = edge->associated_polygons;
             bool b_boundary = asso_polygons.size() <= 1 ? true : false;
             if(b_boundary) {
-                updated_edge_points[i] = CreatePoint((p1 + p2) / 2.0);
+                updated_edge_points[i] = CreatePoint((p1 + p2) / 2.0, {PointOrigin::kEdge, i});
+                AddStencil(edge->id1, 0.5);
+                AddStencil(edge->id2, 0.5);
             } else {
                 Eigen::Vector3d sum_face_pt = Eigen::Vector3d::Zero();
                 //collect neighbour polygons(# should be 2)
                 for(const auto& id : asso_polygons) {
                     sum_face_pt += face_points[id];
                 }
-                updated_edge_points[i] = CreatePoint((p1 + p2 + sum_face_pt) / 4.0);
+                updated_edge_points[i] = CreatePoint((p1 + p2 + sum_face_pt) / 4.0, {PointOrigin::kEdge, i});
+                if(RefinesPrimvars()) {
+                    AddStencil(edge->id1, 0.25);
+                    AddStencil(edge->id2, 0.25);
+                    for(const auto& id : asso_polygons) {
+                        AddFaceStencil(mesh, id, 0.25);
+                    }
+                }
             }
         }
     }
@@ -114,7 +150,11 @@ namespace SubDivision {
 
             if(b_boundary) {
                 Eigen::Vector3d updated_vertex = edge_pt * 0.25 + old_point * 0.75;
-                updated_vertices[i] = CreatePoint(updated_vertex);
+                updated_vertices[i] = CreatePoint(updated_vertex, {PointOrigin::kVertex, i});
+                if(RefinesPrimvars()) {
+                    AddStencil(i, 0.75);
+                    AddEdgeMidpointStencils(mesh, vertex->associated_edges, 0.25);
+                }
 
             } else {
                 //collect neighbour face points
@@ -131,13 +171,28 @@ namespace SubDivision {
                 
                 Eigen::Vector3d updated_vertex = (face_pt + 2 * edge_pt + (num_asso_polygons - 3) * old_point)/ num_asso_polygons;
 
-                updated_vertices[i] = CreatePoint(updated_vertex);
+                updated_vertices[i] = CreatePoint(updated_vertex, {PointOrigin::kVertex, i});
+                if(RefinesPrimvars()) {
+                    AddStencil(i, (num_asso_polygons - 3.0) / num_asso_polygons);
+                    AddEdgeMidpointStencils(mesh, vertex->associated_edges, 2.0 / num_asso_polygons);
+                    for(const auto& id : vertex->associated_polygons) {
+                        AddFaceStencil(mesh, id, 1.0 / (num_asso_polygons * num_asso_polygons));
+                    }
+                }
             }
         }
         return true;
 
     }
 
+    void CatmullClarkSolver::AddEdgeMidpointStencils(const Mesh& mesh, const std::vector<index_t>& edge_ids, double weight) {
+        for(const auto& id : edge_ids) {
+            const std::shared_ptr<Edge>& edge = mesh.EdgeElement(id);
+            AddStencil(edge->id1, 0.5 * weight / edge_ids.size());
+            AddStencil(edge->id2, 0.5 * weight / edge_ids.size());
+        }
+    }
+
     void CatmullClarkSolver::Divide(const Mesh& mesh, const std::vector<index_t>& updated_face_points,
                     const std::vector<index_t>& updated_edge_points,
                     const std::vector<index_t>& updated_vertices,
@@ -154,6 +209,7 @@ namespace SubDivision {
                     //four points may not be on a plane
                     updated_polygons.emplace_back(std::vector<index_t>{updated_face_points[i], updated_edge_points[edge_id1],
                                                                updated_vertices[vertex_id], updated_edge_points[edge_id2] });
+                    AddPolygonParent(i);
                     //   updated_polygons.emplace_back(std::vector<index_t>{updated_face_points[i], updated_edge_points[edge_id1],
                     //                                            updated_vertices[vertex_id]});
                     //   updated_polygons.emplace_back(std::vector<index_t>{updated_face_points[i],
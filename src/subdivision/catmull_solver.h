@@ -5,9 +5,9 @@ namespace SubDivision {
 
     class CatmullClarkSolver: public SubDivisionSolver {
     public:
-        bool Run(const Mesh& mesh, Mesh& updated_mesh) override;
+        bool Run(const Mesh& mesh, Mesh& updated_mesh, SubdivisionStats* stats = nullptr) override;
 
-        void UpdateFacePoints(const std::vector<Eigen::Vector3d>& face_points, 
+        void UpdateFacePoints(const Mesh& mesh, const std::vector<Eigen::Vector3d>& face_points, 
                               std::vector<index_t>& updated_face_points);
 
         void UpdateEdgePoints(const Mesh& mesh, 
@@ -22,5 +22,11 @@ namespace SubDivision {
                     const std::vector<index_t>& updated_vertices,
                     std::vector<std::vector<index_t>>& updated_polygons);
         const bool verbose = false;
+
+    private:
+        //stencil of the face point of `polygon_id` scaled by `weight`
+        void AddFaceStencil(const Mesh& mesh, index_t polygon_id, double weight);
+        //stencil of the average of the midpoints of `edge_ids` scaled by `weight`
+        void AddEdgeMidpointStencils(const Mesh& mesh, const std::vector<index_t>& edge_ids, double weight);
     };
 }
\ No newline at end of file
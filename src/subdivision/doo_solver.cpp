@@ -4,9 +4,16 @@
 #include <algorithm>
 
 namespace SubDivision {
-    bool DooSabinSolver::Run(const Mesh& mesh, Mesh& updated_mesh) {
+    bool DooSabinSolver::Run(const Mesh& mesh, Mesh& updated_mesh, SubdivisionStats* stats) {
+        ResetPointTable();
+        BeginPrimvars(mesh);
+        processed_boundary_vertex_.clear();
+        BeginStats(mesh, 4, stats);
+        CommonUtils::Timer timer;
         std::vector<Eigen::Vector3d> edge_points = GetEdgePoints(mesh);  //mesh.edges <-> edge_points (index consistence)
+        RecordPhase("edge points", timer, stats);
         std::vector<Eigen::Vector3d> face_points = GetFacePoints(mesh);  //mesh.polygons <-> face_points (index consistence)
+        RecordPhase("face points", timer, stats);
         std::vector<std::vector<index_t>> updated_polygons;
         std::vector<std::vector<index_t>> updated_edge_polygons;
         std::vector<std::vector<index_t>> updated_vertex_polygons;
@@ -24,6 +31,7 @@ namespace SubDivision {
                updated_vertex_polygons)) {
             return false;
         }
+        RecordPhase("update vertices", timer, stats);
         if(verbose) {
             std::cout<<"UpdateVertices vertex table:\n";
             PrintPointTable();
@@ -41,6 +49,7 @@ namespace SubDivision {
         }
 
         UpdatedEdgePolygon(mesh, indexed_vertices,updated_edge_polygons);
+        RecordPhase("edge polygons", timer, stats);
         if(verbose) {
             std::cout<<"UpdatedEdgePolygon edge vertices:\n";
             for(int i = 0 ; i < updated_edge_polygons.size() ; i++) {
@@ -53,6 +62,7 @@ namespace SubDivision {
         }
 
         UpdateVertexPolygon(mesh, indexed_vertices,updated_vertex_polygons);
+        RecordPhase("vertex polygons", timer, stats);
         if(verbose) {
             std::cout<<"UpdateVertexPolygon vertex vertices:\n";
             for(int i = 0 ; i < updated_vertex_polygons.size() ; i++) {
@@ -68,6 +78,7 @@ namespace SubDivision {
         
         Divide(mesh,updated_polygons,updated_edge_polygons,updated_vertex_polygons,
                polygons);
+        RecordPhase("divide", timer, stats);
         if(verbose) {
             std::cout<<"Divide:\n";
             for(int i = 0 ; i < polygons.size() ; i++) {
@@ -79,6 +90,21 @@ namespace SubDivision {
             }
         }
         MakeUpMesh(polygons, updated_mesh);
+        RecordPhase("make up mesh", timer, stats);
+        if(RefinesPrimvars()) {
+            RefinePrimvars(mesh, updated_mesh);
+            RecordPhase("primvars", timer, stats);
+        }
+        if(stats) {
+            //a std::map node carries color, parent and two child pointers besides its value
+            const size_t map_node_bytes = sizeof(int) + 3 * sizeof(void*);
+            size_t map_bytes = indexed_vertices.size() * (map_node_bytes + sizeof(*indexed_vertices.begin()));
+            for(const auto& vertex_map : indexed_vertices) {
+                map_bytes += vertex_map.second.size() * (map_node_bytes + sizeof(*vertex_map.second.begin()));
+            }
+            EndStats(updated_mesh, map_bytes + VectorBytes(edge_points) + VectorBytes(face_points) +
+                     VectorBytes(updated_edge_polygons) + VectorBytes(updated_vertex_polygons) + VectorBytes(polygons), stats);
+        }
         if(verbose) {
             std::cout<<"MakeUpMesh:\n";
             for(int i = 0 ; i < polygons.size() ; i++) {
@@ -122,7 +148,8 @@ namespace SubDivision {
                     if(processed_boundary_vertex_.count(vertex_id)) {
                         updated_vertex_id = processed_boundary_vertex_.at(vertex_id);
                     } else {
-                        updated_vertex_id = CreatePoint(vertex->p);
+                        updated_vertex_id = CreatePoint(vertex->p, {PointOrigin::kVertex, vertex_id});
+                        AddStencil(vertex_id, 1.0);
                         processed_boundary_vertex_[vertex_id] = updated_vertex_id;
                     }
                 } else {
@@ -137,7 +164,17 @@ namespace SubDivision {
 
                     const Eigen::Vector3d old_point = mesh.VertexPoint(vertex_id);
                     Eigen::Vector3d updated_vertices = (sum_edge_points + old_point + face_points[i]) / 4.0;
-                    updated_vertex_id = CreatePoint(updated_vertices);
+                    updated_vertex_id = CreatePoint(updated_vertices, {PointOrigin::kFaceCorner, i});
+                    if(RefinesPrimvars()) {
+                        AddStencil(vertex_id, 0.25);
+                        for(const auto& edge_id : asso_edges) {
+                            AddStencil(mesh.EdgeElement(edge_id)->id1, 0.125);
+                            AddStencil(mesh.EdgeElement(edge_id)->id2, 0.125);
+                        }
+                        for(const auto& point_id : points) {
+                            AddStencil(point_id, 0.25 / points.size());
+                        }
+                    }
                 }
                 
                 
@@ -219,20 +256,24 @@ namespace SubDivision {
                 const std::vector<std::vector<index_t>>& updated_edge_polygons,
                 const std::vector<std::vector<index_t>>& updated_vertex_polygons,
                 std::vector<std::vector<index_t>>& polygons) {
-        for(const auto& vertices :updated_polygons) {
+        for(size_t i = 0 ; i < updated_polygons.size() ; i++) {
+            const auto& vertices = updated_polygons[i];
             //generate face 	
             if(vertices.size() >= 3) {
                 polygons.emplace_back(vertices);
+                AddPolygonParent(i);
             }
         }
         for(const auto& vertices: updated_edge_polygons) {
             if(vertices.size() >= 3) {
                 polygons.emplace_back(vertices);
+                AddPolygonParent(-1);
             }
         }
         for(const auto& vertices: updated_vertex_polygons) {
             if(vertices.size() >= 3) {
                 polygons.emplace_back(vertices);
+                AddPolygonParent(-1);
             }
             
         }
@@ -0,0 +1,115 @@
+#include "indexed_mesh.h"
+#include "utils/thread_pool.h"
+#include <Eigen/Geometry>
+#include <algorithm>
+
+namespace SubDivision {
+    namespace {
+        const size_t kGrain = 1 << 14;
+
+        template<typename Func>
+        inline void ForRange(CommonUtils::ThreadPool* pool, size_t n, const Func& func) {
+            if(pool) {
+                pool->ParallelFor(0, n, kGrain, func);
+            } else {
+                func(0, n);
+            }
+        }
+
+        inline size_t NumTriangles(const std::vector<index_t>& face_offsets, size_t i) {
+            const size_t num_points = face_offsets[i + 1] - face_offsets[i];
+            return num_points > 2 ? num_points - 2 : 0;
+        }
+    }
+
+    void BuildIndexedTriangles(const std::vector<Eigen::Vector3d>& vertices,
+                               const std::vector<index_t>& face_offsets,
+                               const std::vector<index_t>& face_indices,
+                               IndexedTriangles& triangles, CommonUtils::ThreadPool* pool) {
+        const size_t num_vertices = vertices.size();
+        const size_t num_polygons = face_offsets.empty() ? 0 : face_offsets.size() - 1;
+
+        //first index of every polygon's fan, lines and points get no triangle
+        std::vector<size_t> triangle_offsets(num_polygons + 1, 0);
+        for(size_t i = 0 ; i < num_polygons ; i++) {
+            triangle_offsets[i + 1] = triangle_offsets[i] + 3 * NumTriangles(face_offsets, i);
+        }
+
+        //fan indices and the area weighted normal of every polygon (sum of the fan cross products)
+        triangles.indices.resize(triangle_offsets[num_polygons]);
+        std::vector<Eigen::Vector3d> polygon_normals(num_polygons);
+        ForRange(pool, num_polygons, [&](size_t polygon_begin, size_t polygon_end) {
+            for(size_t i = polygon_begin ; i < polygon_end ; i++) {
+                const index_t* points = face_indices.data() + face_offsets[i];
+                uint32_t* out = triangles.indices.data() + triangle_offsets[i];
+                Eigen::Vector3d normal = Eigen::Vector3d::Zero();
+                const Eigen::Vector3d& p1 = vertices[points[0]];
+                for(size_t j = 1 ; j + 1 < static_cast<size_t>(face_offsets[i + 1] - face_offsets[i]) ; j++) {
+                    normal += (vertices[points[j]] - p1).cross(vertices[points[j + 1]] - p1);
+                    *out++ = points[0];
+                    *out++ = points[j];
+                    *out++ = points[j + 1];
+                }
+                polygon_normals[i] = normal;
+            }
+        });
+
+        //vertex -> polygons as compressed rows, so the normals are gathered without atomics
+        std::vector<index_t> vertex_offsets(num_vertices + 1, 0);
+        for(const auto v : face_indices) {
+            vertex_offsets[v + 1]++;
+        }
+        for(size_t v = 0 ; v < num_vertices ; v++) {
+            vertex_offsets[v + 1] += vertex_offsets[v];
+        }
+        std::vector<index_t> vertex_polygons(face_indices.size());
+        std::vector<index_t> cursor(vertex_offsets.begin(), vertex_offsets.end() - 1);
+        for(size_t i = 0 ; i < num_polygons ; i++) {
+            for(index_t c = face_offsets[i] ; c < face_offsets[i + 1] ; c++) {
+                vertex_polygons[cursor[face_indices[c]]++] = static_cast<index_t>(i);
+            }
+        }
+        std::vector<index_t>().swap(cursor);
+
+        //unique polygon edges: (smaller id, larger id) keys of every corner, sorted and deduplicated
+        std::vector<uint64_t> edge_keys(face_indices.size());
+        ForRange(pool, num_polygons, [&](size_t polygon_begin, size_t polygon_end) {
+            for(size_t i = polygon_begin ; i < polygon_end ; i++) {
+                for(index_t c = face_offsets[i] ; c < face_offsets[i + 1] ; c++) {
+                    const uint64_t a = static_cast<uint32_t>(face_indices[c]);
+                    const uint64_t b = static_cast<uint32_t>(face_indices[c + 1 < face_offsets[i + 1] ? c + 1 : face_offsets[i]]);
+                    edge_keys[c] = a < b ? (a << 32 | b) : (b << 32 | a);
+                }
+            }
+        });
+        if(pool) {
+            pool->ParallelSort(edge_keys);
+        } else {
+            std::sort(edge_keys.begin(), edge_keys.end());
+        }
+        edge_keys.erase(std::unique(edge_keys.begin(), edge_keys.end()), edge_keys.end());
+        triangles.edge_indices.resize(2 * edge_keys.size());
+        ForRange(pool, edge_keys.size(), [&](size_t edge_begin, size_t edge_end) {
+            for(size_t e = edge_begin ; e < edge_end ; e++) {
+                triangles.edge_indices[2 * e] = static_cast<uint32_t>(edge_keys[e] >> 32);
+                triangles.edge_indices[2 * e + 1] = static_cast<uint32_t>(edge_keys[e]);
+            }
+        });
+
+        triangles.vertex_data.assign(IndexedTriangles::kStride * num_vertices, 0.0f);
+        ForRange(pool, num_vertices, [&](size_t vertex_begin, size_t vertex_end) {
+            for(size_t v = vertex_begin ; v < vertex_end ; v++) {
+                Eigen::Vector3d normal = Eigen::Vector3d::Zero();
+                for(index_t k = vertex_offsets[v] ; k < vertex_offsets[v + 1] ; k++) {
+                    normal += polygon_normals[vertex_polygons[k]];
+                }
+                normal.normalize();
+                float* out = triangles.vertex_data.data() + IndexedTriangles::kStride * v;
+                for(int k = 0 ; k < 3 ; k++) {
+                    out[k] = vertices[v](k);
+                    out[3 + k] = normal(k);
+                }
+            }
+        });
+    }
+}
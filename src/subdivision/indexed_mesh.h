@@ -0,0 +1,33 @@
+#pragma once
+#include "utils/common_utils.h"
+#include <cstdint>
+#include <vector>
+#include <Eigen/Core>
+
+namespace CommonUtils {
+    class ThreadPool;
+}
+
+namespace SubDivision {
+    using CommonUtils::index_t;
+
+    //Triangles sharing one vertex record per mesh vertex, for an indexed draw. Unlike
+    //`Mesh::ConvertToTriangularMesh` (one record per triangle corner, flat normals) the normal
+    //of a record is the area weighted average of the normals of the polygons around the vertex.
+    struct IndexedTriangles {
+        static const int kStride = 6;  //`p(0) p(1) p(2) n(0) n(1) n(2)`, no constant colour
+        std::vector<float> vertex_data;
+        std::vector<uint32_t> indices;  //3 per triangle, polygons are split into fans
+        std::vector<uint32_t> edge_indices;  //2 per polygon edge, each edge once, fan diagonals excluded
+
+        inline size_t NumVertices() const { return vertex_data.size() / kStride; }
+        inline size_t NumIndices() const { return indices.size(); }
+        inline size_t NumEdgeIndices() const { return edge_indices.size(); }
+    };
+
+    //polygons as compressed rows, see `Mesh::SetUp`; `pool`: nullptr builds on the calling thread
+    void BuildIndexedTriangles(const std::vector<Eigen::Vector3d>& vertices,
+                               const std::vector<index_t>& face_offsets,
+                               const std::vector<index_t>& face_indices,
+                               IndexedTriangles& triangles, CommonUtils::ThreadPool* pool = nullptr);
+}
@@ -0,0 +1,132 @@
+#include "level_cache.h"
+#include <cmath>
+
+namespace SubDivision {
+    namespace {
+        const double kQuantisationSteps = 65535.0;
+
+        inline void PutVarint(std::vector<uint8_t>& bytes, uint32_t value) {
+            while(value >= 0x80) {
+                bytes.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            bytes.push_back(static_cast<uint8_t>(value));
+        }
+
+        inline uint32_t GetVarint(const uint8_t*& p) {
+            uint32_t value = 0;
+            for(int shift = 0 ; ; shift += 7) {
+                const uint8_t byte = *p++;
+                value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+                if(!(byte & 0x80)) {
+                    return value;
+                }
+            }
+        }
+
+        inline uint32_t ZigZag(int32_t value) { return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31); }
+        inline int32_t UnZigZag(uint32_t value) { return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1); }
+
+        //the corner predicted for corner `k`: same corner of the previous polygon, else the previous corner
+        inline index_t Predict(const index_t* previous, size_t previous_size, const index_t* current, size_t k) {
+            if(k < previous_size) {
+                return previous[k];
+            }
+            return k > 0 ? current[k - 1] : 0;
+        }
+    }
+
+    void CompressedLevel::Encode(const Mesh& mesh) {
+        const auto& vertices = mesh.Vertices();
+        const auto& polygons = mesh.Polygons();
+
+        Eigen::Vector3d max_corner = Eigen::Vector3d::Zero();
+        origin_ = Eigen::Vector3d::Zero();
+        if(!vertices.empty()) {
+            origin_ = max_corner = vertices[0]->p;
+        }
+        for(const auto& vertex : vertices) {
+            origin_ = origin_.cwiseMin(vertex->p);
+            max_corner = max_corner.cwiseMax(vertex->p);
+        }
+        step_ = (max_corner - origin_) / kQuantisationSteps;
+        positions_.resize(3 * vertices.size());
+        for(size_t i = 0 ; i < vertices.size() ; i++) {
+            for(int k = 0 ; k < 3 ; k++) {
+                const double t = step_(k) > 0.0 ? (vertices[i]->p(k) - origin_(k)) / step_(k) : 0.0;
+                positions_[3 * i + k] = static_cast<uint16_t>(std::lround(t));
+            }
+        }
+
+        size_runs_.clear();
+        corners_.clear();
+        corners_.reserve(mesh.Polygons().size() * 4);
+        num_polygons_ = polygons.size();
+        num_corners_ = 0;
+        const index_t* previous = nullptr;
+        size_t previous_size = 0;
+        for(const auto& polygon : polygons) {
+            const auto& points = polygon->points;
+            if(size_runs_.empty() || size_runs_.back().first != points.size()) {
+                size_runs_.emplace_back(points.size(), 0);
+            }
+            size_runs_.back().second++;
+            for(size_t k = 0 ; k < points.size() ; k++) {
+                PutVarint(corners_, ZigZag(points[k] - Predict(previous, previous_size, points.data(), k)));
+            }
+            previous = points.data();
+            previous_size = points.size();
+            num_corners_ += points.size();
+        }
+        corners_.shrink_to_fit();
+        positions_.shrink_to_fit();
+        size_runs_.shrink_to_fit();
+    }
+
+    void CompressedLevel::Decode(std::vector<Eigen::Vector3d>& vertices, std::vector<index_t>& face_offsets,
+                                 std::vector<index_t>& face_indices) const {
+        vertices.resize(NumVertices());
+        for(size_t i = 0 ; i < vertices.size() ; i++) {
+            vertices[i] = origin_ + Eigen::Vector3d(positions_[3 * i], positions_[3 * i + 1],
+                                                    positions_[3 * i + 2]).cwiseProduct(step_);
+        }
+        face_offsets.resize(num_polygons_ + 1);
+        face_indices.resize(num_corners_);
+        face_offsets[0] = 0;
+        const uint8_t* p = corners_.data();
+        size_t polygon_id = 0, previous_size = 0;
+        index_t* current = face_indices.data();
+        const index_t* previous = nullptr;
+        for(const auto& run : size_runs_) {
+            for(uint32_t r = 0 ; r < run.second ; r++, polygon_id++) {
+                for(size_t k = 0 ; k < run.first ; k++) {
+                    current[k] = Predict(previous, previous_size, current, k) + UnZigZag(GetVarint(p));
+                }
+                face_offsets[polygon_id + 1] = face_offsets[polygon_id] + run.first;
+                previous = current;
+                previous_size = run.first;
+                current += run.first;
+            }
+        }
+    }
+
+    void CompressedLevel::DecodeIndexed(IndexedTriangles& triangles, CommonUtils::ThreadPool* pool) const {
+        std::vector<Eigen::Vector3d> vertices;
+        std::vector<index_t> face_offsets, face_indices;
+        Decode(vertices, face_offsets, face_indices);
+        BuildIndexedTriangles(vertices, face_offsets, face_indices, triangles, pool);
+    }
+
+    size_t CompressedLevel::MemoryBytes() const {
+        return sizeof(*this) + positions_.capacity() * sizeof(uint16_t) +
+               size_runs_.capacity() * sizeof(size_runs_[0]) + corners_.capacity();
+    }
+
+    size_t LevelCache::MemoryBytes() const {
+        size_t bytes = levels_.capacity() * sizeof(CompressedLevel);
+        for(const auto& level : levels_) {
+            bytes += level.MemoryBytes() - sizeof(CompressedLevel);
+        }
+        return bytes;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "mesh.h"
+#include <cstdint>
+#include <vector>
+
+namespace SubDivision {
+
+    //One subdivision level packed for storage: positions are quantised to 16 bits per
+    //coordinate inside the bounding box of the level, polygons are stored as runs of equal
+    //sizes plus zigzag varint deltas of every corner against the same corner of the previous
+    //polygon (children of one parent repeat the face point and neighbour edge points, so most
+    //deltas fit in one byte). Adjacency is not stored, it is rebuilt by `Mesh::SetUp` if needed.
+    class CompressedLevel {
+    public:
+        void Encode(const Mesh& mesh);
+        //positions and compressed rows as taken by `Mesh::SetUp`
+        void Decode(std::vector<Eigen::Vector3d>& vertices, std::vector<index_t>& face_offsets,
+                    std::vector<index_t>& face_indices) const;
+        //shared vertices and a triangle index buffer, as `Mesh::ConvertToIndexedMesh`
+        void DecodeIndexed(IndexedTriangles& triangles, CommonUtils::ThreadPool* pool = nullptr) const;
+
+        inline size_t NumVertices() const { return positions_.size() / 3; }
+        inline size_t NumPolygons() const { return num_polygons_; }
+        size_t MemoryBytes() const;
+        //largest distance between a decoded coordinate and the original one
+        inline double MaxError() const { return 0.5 * step_.maxCoeff(); }
+
+    private:
+        Eigen::Vector3d origin_ = Eigen::Vector3d::Zero();  //min corner of the bounding box
+        Eigen::Vector3d step_ = Eigen::Vector3d::Zero();  //size of one quantisation step
+        std::vector<uint16_t> positions_;  //x, y, z per vertex
+        std::vector<std::pair<uint32_t, uint32_t>> size_runs_;  //(polygon size, number of polygons)
+        std::vector<uint8_t> corners_;  //varint deltas
+        size_t num_polygons_ = 0;
+        size_t num_corners_ = 0;
+    };
+
+    //Levels of one model kept compressed, a level is decoded when it is selected.
+    class LevelCache {
+    public:
+        inline void Clear() { levels_.clear(); }
+        inline void Add(const Mesh& mesh) {
+            levels_.emplace_back();
+            levels_.back().Encode(mesh);
+        }
+        //a level encoded elsewhere, e.g. on a worker thread
+        inline void Add(CompressedLevel&& level) { levels_.emplace_back(std::move(level)); }
+        inline size_t NumLevels() const { return levels_.size(); }
+        inline const CompressedLevel& Level(size_t i) const { return levels_.at(i); }
+        size_t MemoryBytes() const;
+
+    private:
+        std::vector<CompressedLevel> levels_;
+    };
+}
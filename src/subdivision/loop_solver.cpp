@@ -12,18 +12,23 @@ namespace SubDivision {
         return true;
     }
 
-    bool LoopSolver::Run(const Mesh& mesh, Mesh& updated_mesh) {
-        
+    bool LoopSolver::Run(const Mesh& mesh, Mesh& updated_mesh, SubdivisionStats* stats) {
+        ResetPointTable();
+        BeginPrimvars(mesh);
+        BeginStats(mesh, 6, stats);
+        CommonUtils::Timer timer;
         if(!CheckCheirality(mesh)) {
             //std::cerr << "Error: input mesh contains non-triangles.\n";
             return false;
         }
+        RecordPhase("check triangles", timer, stats);
         
         std::vector<index_t> updated_edge_points; //mesh.edges <-> updated_edge_points (index consistence)
         std::vector<index_t> updated_vertices; //mesh.vertices <-> updated_vertices (index consistence)
         std::vector<std::vector<index_t>> polygons;
         
         UpdateEdgePoints(mesh, updated_edge_points);
+        RecordPhase("update edge points", timer, stats);
         if(verbose) {
             std::cout<<"UpdateEdgePoints:\n";
             PrintPointTable();
@@ -31,11 +36,13 @@ namespace SubDivision {
         if(!UpdateVertices(mesh, updated_vertices)) {
             return false;
         }
+        RecordPhase("update vertices", timer, stats);
         if(verbose) {
             std::cout<<"UpdateVertices:\n";
             PrintPointTable();
         }
         Divide(mesh, updated_edge_points, updated_vertices, polygons);
+        RecordPhase("divide", timer, stats);
         if(verbose) {
             std::cout<<"Divide:\n";
             for(int i = 0 ; i < polygons.size() ; i++) {
@@ -47,6 +54,12 @@ namespace SubDivision {
             }
         }
         MakeUpMesh(polygons, updated_mesh);
+        RecordPhase("make up mesh", timer, stats);
+        if(RefinesPrimvars()) {
+            RefinePrimvars(mesh, updated_mesh);
+            RecordPhase("primvars", timer, stats);
+        }
+        EndStats(updated_mesh, VectorBytes(updated_edge_points) + VectorBytes(updated_vertices) + VectorBytes(polygons), stats);
         if(verbose) {
             std::cout<<"MakeUpMesh:\n";
             for(int i = 0 ; i < polygons.size() ; i++) {
@@ -71,7 +84,9 @@ namespace SubDivision {
             const std::vector<index_t>& asso_polygons = edge->associated_polygons;
             bool b_boundary = asso_polygons.size() <= 1 ? true : false;
             if(b_boundary) {
-                updated_edge_points[i] = CreatePoint((p1 + p2) / 2.0);
+                updated_edge_points[i] = CreatePoint((p1 + p2) / 2.0, {PointOrigin::kEdge, i});
+                AddStencil(edge->id1, 0.5);
+                AddStencil(edge->id2, 0.5);
             } else {
                 Eigen::Vector3d sum_neighbour_vertices = Eigen::Vector3d::Zero();
                 for(const auto& polygon_id : asso_polygons) {  // #asso_polygons should be 2
@@ -83,7 +98,18 @@ namespace SubDivision {
                     }
                 }
                 Eigen::Vector3d updated_edge_point = 0.375 * (p1+p2) + 0.125 * sum_neighbour_vertices;
-                updated_edge_points[i] = CreatePoint(updated_edge_point);
+                updated_edge_points[i] = CreatePoint(updated_edge_point, {PointOrigin::kEdge, i});
+                if(RefinesPrimvars()) {
+                    AddStencil(edge->id1, 0.375);
+                    AddStencil(edge->id2, 0.375);
+                    for(const auto& polygon_id : asso_polygons) {
+                        for(const auto& vertex_id : mesh.PolygonElement(polygon_id)->points) {
+                            if(vertex_id != edge->id1 && vertex_id!= edge->id2) {
+                                AddStencil(vertex_id, 0.125);
+                            }
+                        }
+                    }
+                }
 
             }
         }
@@ -121,7 +147,8 @@ namespace SubDivision {
             // update vertex
             if(b_boundary) {
                 Eigen::Vector3d updated_vertex = 0.125 * sum_assc_verices + 0.75 * old_point;
-                updated_vertices[i] = CreatePoint(updated_vertex);
+                updated_vertices[i] = CreatePoint(updated_vertex, {PointOrigin::kVertex, i});
+                AddNeighbourStencils(mesh, i, 0.125, 0.75);
             } else {
                 float beta = 0.0;
                 if(degree == 3) {
@@ -130,7 +157,8 @@ namespace SubDivision {
                     beta = 3.0 / (8 * degree);
                 }
                 Eigen::Vector3d updated_vertex = beta * sum_assc_verices + (1 - degree * beta) * old_point;
-                updated_vertices[i] = CreatePoint(updated_vertex);
+                updated_vertices[i] = CreatePoint(updated_vertex, {PointOrigin::kVertex, i});
+                AddNeighbourStencils(mesh, i, beta, 1 - degree * beta);
             }
 
         }
@@ -152,6 +180,7 @@ namespace SubDivision {
                 if(Mesh::CommonVertex(mesh.EdgeElement(edge_id1), mesh.EdgeElement(edge_id2), vertex_id)) {
                     updated_polygons.emplace_back(std::vector<index_t>{updated_edge_points[edge_id1], updated_vertices[vertex_id],
                                                                         updated_edge_points[edge_id2]});
+                    AddPolygonParent(i);
                 } else {
                     //std::cerr << "neighbour edges are not continous.\n";
                 }
@@ -159,6 +188,21 @@ namespace SubDivision {
             assert(edges.size() == 3);
             updated_polygons.emplace_back(std::vector<index_t>{updated_edge_points[edges[0]], updated_edge_points[edges[1]],
                                                                         updated_edge_points[edges[2]]});
+            AddPolygonParent(i);
+        }
+    }
+
+    void LoopSolver::AddNeighbourStencils(const Mesh& mesh, index_t vertex_id, double neighbour_weight, double self_weight) {
+        if(!RefinesPrimvars()) {
+            return;
+        }
+        AddStencil(vertex_id, self_weight);
+        for(const auto& edge_id : mesh.VertexElement(vertex_id)->associated_edges) {  //the same neighbours as `UpdateVertices`
+            const std::shared_ptr<Edge>& edge = mesh.EdgeElement(edge_id);
+            const index_t id = edge->id1 == vertex_id ? edge->id2 : edge->id1;
+            if(id != vertex_id) {
+                AddStencil(id, neighbour_weight);
+            }
         }
     }
 
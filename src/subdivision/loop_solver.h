@@ -4,7 +4,7 @@
 namespace SubDivision {
     class LoopSolver: public SubDivisionSolver {
     public:
-        bool Run(const Mesh& mesh, Mesh& updated_mesh) override;
+        bool Run(const Mesh& mesh, Mesh& updated_mesh, SubdivisionStats* stats = nullptr) override;
 
         bool CheckCheirality(const Mesh& mesh);
 
@@ -18,5 +18,9 @@ namespace SubDivision {
                     const std::vector<index_t>& updated_vertices,
                     std::vector<std::vector<index_t>>& updated_polygons);
         const bool verbose = false;
+
+    private:
+        //stencil of an updated vertex: `self_weight` on itself, `neighbour_weight` on every neighbour
+        void AddNeighbourStencils(const Mesh& mesh, index_t vertex_id, double neighbour_weight, double self_weight);
     };
 }
\ No newline at end of file
@@ -1,12 +1,27 @@
 #include "mesh.h"
+#include "mesh_writer.h"
 #include <unordered_map>
 #include <map>
 #include <cmath>
+#include <fstream>
+#include <iomanip>
 
 namespace SubDivision {
 
     void Mesh::SetUp(const std::vector<Eigen::Vector3d>& vertices, 
                    const std::vector<std::vector<index_t>>& polygons) {
+        std::vector<index_t> face_offsets(1, 0), face_indices;
+        face_offsets.reserve(polygons.size() + 1);
+        for(const auto& polygon : polygons) {
+            face_indices.insert(face_indices.end(), polygon.begin(), polygon.end());
+            face_offsets.emplace_back(face_indices.size());
+        }
+        SetUp(vertices, face_offsets, face_indices);
+    }
+
+    void Mesh::SetUp(const std::vector<Eigen::Vector3d>& vertices,
+                   const std::vector<index_t>& face_offsets,
+                   const std::vector<index_t>& face_indices) {
         
         /////////////////////////
         //establish vertex table
@@ -21,21 +36,20 @@ namespace SubDivision {
         /////////////////////////
         //establish edge table and polygon table
         /////////////////////////
-        polygons_.reserve(polygons.size());
+        const size_t num_polygons = face_offsets.empty() ? 0 : face_offsets.size() - 1;
+        polygons_.reserve(num_polygons);
         std::map<std::pair<index_t,index_t>, size_t> edge_pairs;
-        for(size_t i = 0 ; i < polygons.size() ; i++) {
-            const std::vector<index_t>& polygon_i = polygons[i];
+        for(size_t i = 0 ; i < num_polygons ; i++) {
+            const index_t* polygon_i = face_indices.data() + face_offsets[i];
+            const int num_points = face_offsets[i + 1] - face_offsets[i];
             auto res_polygon = std::make_shared<Polygon>();
 
             //insert vertices
-            res_polygon->points.resize(polygon_i.size());
-            for(int j = 0 ,sz = polygon_i.size(); j < sz ; j++) {
-                res_polygon->points[j] = polygon_i[j]; // alternative
-            }
+            res_polygon->points.assign(polygon_i, polygon_i + num_points);
             
             //create and insert edges
-            res_polygon->edges.reserve(polygon_i.size());
-            for(int j = 0 ,sz = polygon_i.size(); j < sz ; j++) {
+            res_polygon->edges.reserve(num_points);
+            for(int j = 0 ,sz = num_points; j < sz ; j++) {
                 int nxt = (j + 1) % sz;
 
                 std::pair<index_t, index_t> edge_pair(polygon_i[j], polygon_i[nxt]);
@@ -92,6 +106,39 @@ namespace SubDivision {
         ResetNorm();
     }
 
+    void Mesh::SetUp(const TopologyView& view) {
+        vertices_.resize(view.num_vertices);
+        for(size_t i = 0 ; i < view.num_vertices ; i++) {
+            auto vertex = std::make_shared<Vertex>();
+            vertex->id = i;
+            vertex->p = Eigen::Vector3d(view.positions[3 * i], view.positions[3 * i + 1], view.positions[3 * i + 2]);
+            vertex->associated_edges.assign(view.vertex_edges + view.vertex_edge_offsets[i],
+                                            view.vertex_edges + view.vertex_edge_offsets[i + 1]);
+            vertex->associated_polygons.assign(view.vertex_polygons + view.vertex_polygon_offsets[i],
+                                               view.vertex_polygons + view.vertex_polygon_offsets[i + 1]);
+            vertices_[i] = vertex;
+        }
+        edges_.resize(view.num_edges);
+        for(size_t i = 0 ; i < view.num_edges ; i++) {
+            auto edge = std::make_shared<Edge>();
+            edge->id1 = view.edges[2 * i];
+            edge->id2 = view.edges[2 * i + 1];
+            edge->associated_polygons.assign(view.edge_polygons + view.edge_polygon_offsets[i],
+                                             view.edge_polygons + view.edge_polygon_offsets[i + 1]);
+            edges_[i] = edge;
+        }
+        polygons_.resize(view.num_polygons);
+        for(size_t i = 0 ; i < view.num_polygons ; i++) {
+            auto polygon = std::make_shared<Polygon>();
+            polygon->points.assign(view.polygon_points + view.polygon_offsets[i],
+                                   view.polygon_points + view.polygon_offsets[i + 1]);
+            polygon->edges.assign(view.polygon_edges + view.polygon_offsets[i],
+                                  view.polygon_edges + view.polygon_offsets[i + 1]);
+            polygons_[i] = polygon;
+        }
+        ResetNorm();
+    }
+
     void Mesh::ResetNorm() {
 
         for(int i = 0 ; i < polygons_.size() ; i++) {
@@ -128,7 +175,21 @@ namespace SubDivision {
     //     }
     // }
 
-    std::tuple<std::vector<float>, size_t> Mesh::ConvertToTriangularMesh() {
+    void Mesh::ConvertToIndexedMesh(IndexedTriangles& triangles, CommonUtils::ThreadPool* pool) const {
+        std::vector<Eigen::Vector3d> vertices(vertices_.size());
+        for(size_t i = 0 ; i < vertices_.size() ; i++) {
+            vertices[i] = vertices_[i]->p;
+        }
+        std::vector<index_t> face_offsets(1, 0), face_indices;
+        face_offsets.reserve(polygons_.size() + 1);
+        for(const auto& polygon : polygons_) {
+            face_indices.insert(face_indices.end(), polygon->points.begin(), polygon->points.end());
+            face_offsets.emplace_back(face_indices.size());
+        }
+        BuildIndexedTriangles(vertices, face_offsets, face_indices, triangles, pool);
+    }
+
+    std::tuple<std::vector<float>, size_t> Mesh::ConvertToTriangularMesh() const {
     
         std::vector<float> triangular_mesh;
         
@@ -204,6 +265,70 @@ namespace SubDivision {
         }
     }
 
+    bool Mesh::SaveObj(const std::string& file_path) const {
+        return WriteObj(*this, file_path);
+    }
+
+    size_t Mesh::MemoryBytes() const {
+        //every element is a separate `make_shared` block: object + control block
+        const size_t control_block_bytes = 2 * sizeof(long) + sizeof(void*);
+        size_t bytes = vertices_.capacity() * sizeof(std::shared_ptr<Vertex>) +
+                       edges_.capacity() * sizeof(std::shared_ptr<Edge>) +
+                       polygons_.capacity() * sizeof(std::shared_ptr<Polygon>);
+        for(const auto& vertex : vertices_) {
+            bytes += sizeof(Vertex) + control_block_bytes +
+                     (vertex->associated_edges.capacity() + vertex->associated_polygons.capacity()) * sizeof(index_t);
+        }
+        for(const auto& edge : edges_) {
+            bytes += sizeof(Edge) + control_block_bytes + edge->associated_polygons.capacity() * sizeof(index_t);
+        }
+        for(const auto& polygon : polygons_) {
+            bytes += sizeof(Polygon) + control_block_bytes +
+                     (polygon->points.capacity() + polygon->edges.capacity()) * sizeof(index_t);
+        }
+        for(const auto& channel : primvars_) {
+            bytes += channel.values.capacity() * sizeof(float) + channel.corner_indices.capacity() * sizeof(index_t);
+        }
+        return bytes;
+    }
+
+    bool Mesh::AddPrimvar(PrimvarChannel channel) {
+        bool b_valid = channel.width > 0 && channel.values.size() % channel.width == 0;
+        if(b_valid && !channel.b_face_varying) {
+            b_valid = channel.NumValues() == vertices_.size();
+        } else if(b_valid) {
+            size_t num_corners = 0;
+            for(const auto& polygon : polygons_) {
+                num_corners += polygon->points.size();
+            }
+            b_valid = channel.corner_indices.size() == num_corners;
+            for(size_t i = 0 ; b_valid && i < num_corners ; i++) {
+                b_valid = channel.corner_indices[i] >= 0 && static_cast<size_t>(channel.corner_indices[i]) < channel.NumValues();
+            }
+        }
+        if(!b_valid) {
+            std::cerr << "invalid primvar channel " + channel.name << std::endl;
+            return false;
+        }
+        for(auto& primvar : primvars_) {
+            if(primvar.name == channel.name) {
+                primvar = std::move(channel);
+                return true;
+            }
+        }
+        primvars_.emplace_back(std::move(channel));
+        return true;
+    }
+
+    const PrimvarChannel* Mesh::FindPrimvar(const std::string& name) const {
+        for(const auto& channel : primvars_) {
+            if(channel.name == name) {
+                return &channel;
+            }
+        }
+        return nullptr;
+    }
+
     void Mesh::PrintPolygon() {
         for(int i = 0 ; i < polygons_.size() ; i++) {
             const size_t num_points = polygons_[i]->points.size();
@@ -220,7 +345,7 @@ namespace SubDivision {
         }
     }
 
-    void Mesh::ScaleModel(const float max_scale) {
+    std::pair<Eigen::Vector3d, double> Mesh::ScaleModel(const float max_scale) {
         
         // collect the center and scale of model
         Eigen::Vector3d model_center = Eigen::Vector3d::Zero();
@@ -247,11 +372,15 @@ namespace SubDivision {
             max_radius = max_radius < radius ? radius : max_radius;
         }
 
+        double scale = max_scale / max_radius;
+        TransformModel(model_center, scale);
+        return std::make_pair(model_center, scale);
+    }
+
+    void Mesh::TransformModel(const Eigen::Vector3d& model_center, const double scale) {
         // Align model to screen frame
         Eigen::Vector3d translation_3d(0.0, 0.0, 0.0);
 
-        double scale = max_scale / max_radius;
-
         for(auto& vertex : vertices_) {
             auto& point = vertex->p;
             point= (point - model_center) * scale + translation_3d;  //scale
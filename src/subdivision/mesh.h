@@ -5,6 +5,8 @@
 #include <memory>
 #include "utils/common_utils.h"
 #include "base/model.h"
+#include "primvar.h"
+#include "indexed_mesh.h"
 
 namespace SubDivision {
      using CommonUtils::index_t;
@@ -42,11 +44,39 @@ namespace SubDivision {
        
     };
 
+    //Read-only arrays of a mesh and of its adjacency, e.g. views into a mapped `.smesh` file.
+    //Every `*_offsets` array has one entry more than its elements: element i owns
+    //[offsets[i], offsets[i + 1]) of the array it indexes.
+    struct TopologyView {
+        size_t num_vertices = 0;
+        size_t num_edges = 0;
+        size_t num_polygons = 0;
+        const double* positions = nullptr;  //x, y, z per vertex
+        const index_t* polygon_offsets = nullptr;
+        const index_t* polygon_points = nullptr;
+        const index_t* polygon_edges = nullptr;  //edge j joins point j and j + 1, as `Polygon::edges`
+        const index_t* edges = nullptr;  //id1, id2 per edge
+        const index_t* edge_polygon_offsets = nullptr;
+        const index_t* edge_polygons = nullptr;
+        const index_t* vertex_edge_offsets = nullptr;
+        const index_t* vertex_edges = nullptr;
+        const index_t* vertex_polygon_offsets = nullptr;
+        const index_t* vertex_polygons = nullptr;
+    };
+
     class Mesh {
 public:
         void SetUp(const std::vector<Eigen::Vector3d>& vertices, 
                    const std::vector<std::vector<index_t>>& polygons);
-        std::tuple<std::vector<float>, size_t> ConvertToTriangularMesh();
+        //polygon i is face_indices[face_offsets[i] .. face_offsets[i + 1]), as filled by `CommonUtils::CsrObjSink`
+        void SetUp(const std::vector<Eigen::Vector3d>& vertices,
+                   const std::vector<index_t>& face_offsets,
+                   const std::vector<index_t>& face_indices);
+        //copy precomputed topology, no edge search
+        void SetUp(const TopologyView& view);
+        std::tuple<std::vector<float>, size_t> ConvertToTriangularMesh() const;
+        //one record per vertex and a triangle index buffer, see `IndexedTriangles`
+        void ConvertToIndexedMesh(IndexedTriangles& triangles, CommonUtils::ThreadPool* pool = nullptr) const;
 
         static bool CommonVertex(const std::shared_ptr<Edge>& e1, const std::shared_ptr<Edge>& e2, index_t& vertex_id) {
             if(e1->id1 == e2->id1 || e1->id1 == e2->id2) {
@@ -69,8 +99,16 @@ public:
         inline const std::vector<std::shared_ptr<Polygon>>& Polygons() const {return polygons_;}
         void PrintPolygon();
         void PrintObj();
+        bool SaveObj(const std::string& file_path) const;
+        size_t MemoryBytes() const;  //estimated heap footprint of the topology tables and primvars
         void FeedNorm(const Model& model);
 
+        //attach a channel after `SetUp`, false if its sizes do not match the mesh;
+        //a channel with the same name is replaced
+        bool AddPrimvar(PrimvarChannel channel);
+        inline const std::vector<PrimvarChannel>& Primvars() const {return primvars_;}
+        const PrimvarChannel* FindPrimvar(const std::string& name) const;  //nullptr if absent
+
         inline bool FindEdge(const index_t& polygon_id, const index_t& start_index,
                              const index_t& vertex_id1,const index_t& vertex_id2,
                              index_t& edge_id) const { // find the edge whose start points is vertex1 and end point is vertex 2 in the polygon
@@ -88,7 +126,9 @@ public:
             return false;
         }
 
-            void ScaleModel(const float max_scale);
+            //center the model and fit it into a sphere of radius `max_scale`, returns the (center, scale) applied
+            std::pair<Eigen::Vector3d, double> ScaleModel(const float max_scale);
+            void TransformModel(const Eigen::Vector3d& model_center, const double scale);
 
        
 
@@ -98,6 +138,7 @@ private:
         std::vector<std::shared_ptr<Vertex>> vertices_;
         std::vector<std::shared_ptr<Edge>> edges_;
         std::vector<std::shared_ptr<Polygon>> polygons_;
+        std::vector<PrimvarChannel> primvars_;
         const bool verbose = false;
 
 
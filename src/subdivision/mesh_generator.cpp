@@ -0,0 +1,339 @@
+#include "mesh_generator.h"
+#include <cmath>
+#include <initializer_list>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include "utils/geometry_utils.h"
+
+namespace SubDivision {
+namespace MeshGenerator {
+
+    namespace {
+        inline void Clear(std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices) {
+            face_offsets.assign(1, 0);
+            face_indices.clear();
+        }
+
+        inline void AddPolygon(std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices,
+                               std::initializer_list<index_t> points) {
+            face_indices.insert(face_indices.end(), points);
+            face_offsets.emplace_back(face_indices.size());
+        }
+
+        //drop vertices no polygon refers to, isolated vertices break the vertex rules of the solvers
+        void RemoveUnreferencedVertices(std::vector<Eigen::Vector3d>& vertices, std::vector<index_t>& face_indices) {
+            std::vector<index_t> remap(vertices.size(), -1);
+            for(const auto id : face_indices) {
+                remap[id] = 0;
+            }
+            index_t num_vertices = 0;
+            for(size_t i = 0 ; i < vertices.size() ; i++) {
+                if(remap[i] == 0) {
+                    remap[i] = num_vertices;
+                    vertices[num_vertices++] = vertices[i];
+                }
+            }
+            vertices.resize(num_vertices);
+            for(auto& id : face_indices) {
+                id = remap[id];
+            }
+        }
+    }
+
+    void QuadGrid(size_t num_faces, std::vector<Eigen::Vector3d>& vertices,
+                  std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices) {
+        const size_t n_x = std::max<size_t>(1, std::llround(std::sqrt(static_cast<double>(num_faces))));
+        const size_t n_y = std::max<size_t>(1, (num_faces + n_x - 1) / n_x);
+        vertices.clear();
+        Clear(face_offsets, face_indices);
+        vertices.reserve((n_x + 1) * (n_y + 1));
+        face_offsets.reserve(n_x * n_y + 1);
+        face_indices.reserve(4 * n_x * n_y);
+        for(size_t j = 0 ; j <= n_y ; j++) {
+            for(size_t i = 0 ; i <= n_x ; i++) {
+                vertices.emplace_back(static_cast<double>(i) / n_x, static_cast<double>(j) / n_y, 0.0);
+            }
+        }
+        auto id = [n_x](size_t i, size_t j) { return static_cast<index_t>(j * (n_x + 1) + i); };
+        for(size_t j = 0 ; j < n_y ; j++) {
+            for(size_t i = 0 ; i < n_x ; i++) {
+                AddPolygon(face_offsets, face_indices, {id(i, j), id(i + 1, j), id(i + 1, j + 1), id(i, j + 1)});
+            }
+        }
+    }
+
+    void Torus(size_t num_faces, std::vector<Eigen::Vector3d>& vertices,
+               std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices) {
+        const double major_radius = 1.0, minor_radius = 0.4;
+        const size_t n_u = std::max<size_t>(3, std::llround(std::sqrt(static_cast<double>(num_faces))));
+        const size_t n_v = std::max<size_t>(3, (num_faces + n_u - 1) / n_u);
+        vertices.clear();
+        Clear(face_offsets, face_indices);
+        vertices.reserve(n_u * n_v);
+        face_offsets.reserve(n_u * n_v + 1);
+        face_indices.reserve(4 * n_u * n_v);
+        for(size_t j = 0 ; j < n_v ; j++) {
+            const double v = 2.0 * M_PI * j / n_v;
+            for(size_t i = 0 ; i < n_u ; i++) {
+                const double u = 2.0 * M_PI * i / n_u;
+                const double radius = major_radius + minor_radius * std::cos(v);
+                vertices.emplace_back(radius * std::cos(u), radius * std::sin(u), minor_radius * std::sin(v));
+            }
+        }
+        auto id = [n_u, n_v](size_t i, size_t j) { return static_cast<index_t>((j % n_v) * n_u + (i % n_u)); };
+        for(size_t j = 0 ; j < n_v ; j++) {
+            for(size_t i = 0 ; i < n_u ; i++) {
+                AddPolygon(face_offsets, face_indices, {id(i, j), id(i + 1, j), id(i + 1, j + 1), id(i, j + 1)});
+            }
+        }
+    }
+
+    void Icosphere(size_t num_faces, std::vector<Eigen::Vector3d>& vertices,
+                   std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices) {
+        const double t = (1.0 + std::sqrt(5.0)) / 2.0;
+        vertices = {
+            {-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0},
+            {0, -1, t}, {0, 1, t}, {0, -1, -t}, {0, 1, -t},
+            {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1}
+        };
+        for(auto& vertex : vertices) {
+            vertex.normalize();
+        }
+        //three corners per triangle, the rows are written once the last split is done
+        std::vector<index_t> triangles = {
+            0, 11, 5,  0, 5, 1,  0, 1, 7,  0, 7, 10,  0, 10, 11,
+            1, 5, 9,  5, 11, 4,  11, 10, 2,  10, 7, 6,  7, 1, 8,
+            3, 9, 4,  3, 4, 2,  3, 2, 6,  3, 6, 8,  3, 8, 9,
+            4, 9, 5,  2, 4, 11,  6, 2, 10,  8, 6, 7,  9, 8, 1
+        };
+
+        //split while 4 * n is closer to num_faces than n, i.e. while 5 * n < 2 * num_faces
+        while(5 * (triangles.size() / 3) < 2 * num_faces) {
+            const size_t num_triangles = triangles.size() / 3;
+            std::unordered_map<uint64_t, index_t> midpoints;
+            midpoints.reserve(num_triangles * 3 / 2);
+            auto midpoint = [&](index_t a, index_t b) {
+                const uint64_t key = (static_cast<uint64_t>(std::min(a, b)) << 32) | static_cast<uint32_t>(std::max(a, b));
+                auto it = midpoints.find(key);
+                if(it != midpoints.end()) {
+                    return it->second;
+                }
+                const index_t id = vertices.size();
+                vertices.emplace_back((vertices[a] + vertices[b]).normalized());
+                midpoints.emplace(key, id);
+                return id;
+            };
+
+            std::vector<index_t> updated_triangles;
+            updated_triangles.reserve(triangles.size() * 4);
+            for(size_t t = 0 ; t < num_triangles ; t++) {
+                const index_t* triangle = triangles.data() + 3 * t;
+                const index_t a = midpoint(triangle[0], triangle[1]);
+                const index_t b = midpoint(triangle[1], triangle[2]);
+                const index_t c = midpoint(triangle[2], triangle[0]);
+                updated_triangles.insert(updated_triangles.end(), {triangle[0], a, c, triangle[1], b, a,
+                                                                   triangle[2], c, b, a, b, c});
+            }
+            triangles.swap(updated_triangles);
+        }
+        face_offsets.resize(triangles.size() / 3 + 1);
+        for(size_t t = 0 ; t < face_offsets.size() ; t++) {
+            face_offsets[t] = static_cast<index_t>(3 * t);
+        }
+        face_indices.swap(triangles);
+    }
+
+    void RandomPolygonMesh(size_t num_faces, unsigned int seed, std::vector<Eigen::Vector3d>& vertices,
+                           std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices) {
+        Torus(num_faces, vertices, face_offsets, face_indices);
+        const size_t n_u = std::max<size_t>(3, std::llround(std::sqrt(static_cast<double>(num_faces))));
+        size_t n_v = (face_offsets.size() - 1) / n_u;
+        //cells are only merged along even rows, so no vertex loses two edges (valence 2)
+        //and the wrap-around row n_v - 1 must be odd
+        const bool b_odd_rows = n_v % 2 == 1;
+
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> distribution(0.0, 1.0);
+        auto id = [&](size_t i, size_t j) { return static_cast<index_t>((j % n_v) * n_u + (i % n_u)); };
+
+        std::vector<index_t> updated_face_offsets, updated_face_indices;
+        Clear(updated_face_offsets, updated_face_indices);
+        updated_face_offsets.reserve(face_offsets.size() * 3 / 2);
+        updated_face_indices.reserve(face_indices.size() * 3 / 2);
+        for(size_t j = 0 ; j < n_v ; j++) {
+            const bool b_merge_row = j % 2 == 0 && !(b_odd_rows && j + 1 == n_v);
+            for(size_t i = 0 ; i < n_u ;) {
+                const double r = distribution(generator);
+                if(b_merge_row && r < 0.1 && i + 3 <= n_u) {
+                    //octagon from three cells
+                    AddPolygon(updated_face_offsets, updated_face_indices, {id(i, j), id(i + 1, j), id(i + 2, j), id(i + 3, j),
+                                                                       id(i + 3, j + 1), id(i + 2, j + 1), id(i + 1, j + 1),
+                                                                       id(i, j + 1)});
+                    i += 3;
+                } else if(b_merge_row && r < 0.35 && i + 2 <= n_u) {
+                    //hexagon from two cells
+                    AddPolygon(updated_face_offsets, updated_face_indices, {id(i, j), id(i + 1, j), id(i + 2, j),
+                                                                       id(i + 2, j + 1), id(i + 1, j + 1), id(i, j + 1)});
+                    i += 2;
+                } else if(r > 0.8) {
+                    //two triangles, random diagonal
+                    if(distribution(generator) < 0.5) {
+                        AddPolygon(updated_face_offsets, updated_face_indices, {id(i, j), id(i + 1, j), id(i + 1, j + 1)});
+                        AddPolygon(updated_face_offsets, updated_face_indices, {id(i, j), id(i + 1, j + 1), id(i, j + 1)});
+                    } else {
+                        AddPolygon(updated_face_offsets, updated_face_indices, {id(i, j), id(i + 1, j), id(i, j + 1)});
+                        AddPolygon(updated_face_offsets, updated_face_indices, {id(i + 1, j), id(i + 1, j + 1), id(i, j + 1)});
+                    }
+                    i++;
+                } else {
+                    AddPolygon(updated_face_offsets, updated_face_indices, {id(i, j), id(i + 1, j), id(i + 1, j + 1), id(i, j + 1)});
+                    i++;
+                }
+            }
+        }
+        face_offsets.swap(updated_face_offsets);
+        face_indices.swap(updated_face_indices);
+    }
+
+    void GridWithHoles(size_t num_faces, size_t hole_size, std::vector<Eigen::Vector3d>& vertices,
+                       std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices) {
+        hole_size = std::max<size_t>(1, hole_size);
+        const size_t period = 2 * hole_size + 1;  //hole + gap of hole_size + 1 cells
+        const double kept_ratio = 1.0 - static_cast<double>(hole_size * hole_size) / (period * period);
+        const size_t n = std::max<size_t>(period + 2, std::llround(std::sqrt(num_faces / kept_ratio)));
+
+        vertices.clear();
+        Clear(face_offsets, face_indices);
+        vertices.reserve((n + 1) * (n + 1));
+        face_offsets.reserve(num_faces + 1);
+        face_indices.reserve(4 * num_faces);
+        for(size_t j = 0 ; j <= n ; j++) {
+            for(size_t i = 0 ; i <= n ; i++) {
+                vertices.emplace_back(static_cast<double>(i) / n, static_cast<double>(j) / n, 0.0);
+            }
+        }
+        //holes start one cell inside the border and must fit completely, so that
+        //neither the border nor two holes share a vertex and regular vertices remain between them
+        const size_t num_holes = (n - 1) / period;
+        auto in_hole = [&](size_t i) {
+            if(i < 1) {
+                return false;
+            }
+            const size_t block = (i - 1) / period;
+            return block < num_holes && (i - 1) % period < hole_size && 1 + block * period + hole_size <= n - 1;
+        };
+        auto id = [n](size_t i, size_t j) { return static_cast<index_t>(j * (n + 1) + i); };
+        for(size_t j = 0 ; j < n ; j++) {
+            for(size_t i = 0 ; i < n ; i++) {
+                if(in_hole(i) && in_hole(j)) {
+                    continue;
+                }
+                AddPolygon(face_offsets, face_indices, {id(i, j), id(i + 1, j), id(i + 1, j + 1), id(i, j + 1)});
+            }
+        }
+        RemoveUnreferencedVertices(vertices, face_indices);
+    }
+
+    void PoleSphere(size_t num_faces, size_t pole_valence, std::vector<Eigen::Vector3d>& vertices,
+                    std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices) {
+        const size_t num_segments = std::max<size_t>(3, pole_valence);
+        const size_t num_rings = std::max<size_t>(2, num_faces / num_segments);
+        vertices.clear();
+        Clear(face_offsets, face_indices);
+        vertices.reserve(2 + (num_rings - 1) * num_segments);
+        face_offsets.reserve(num_rings * num_segments + 1);
+        face_indices.reserve(4 * num_rings * num_segments);
+
+        vertices.emplace_back(0.0, 0.0, 1.0);  //north pole
+        for(size_t k = 1 ; k < num_rings ; k++) {
+            const double theta = M_PI * k / num_rings;
+            for(size_t i = 0 ; i < num_segments ; i++) {
+                const double phi = 2.0 * M_PI * i / num_segments;
+                vertices.emplace_back(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+            }
+        }
+        const index_t south_pole = vertices.size();
+        vertices.emplace_back(0.0, 0.0, -1.0);
+
+        auto id = [num_segments](size_t ring, size_t i) {
+            return static_cast<index_t>(1 + (ring - 1) * num_segments + i % num_segments);
+        };
+        for(size_t i = 0 ; i < num_segments ; i++) {
+            AddPolygon(face_offsets, face_indices, {0, id(1, i), id(1, i + 1)});
+        }
+        for(size_t k = 1 ; k + 1 < num_rings ; k++) {
+            for(size_t i = 0 ; i < num_segments ; i++) {
+                AddPolygon(face_offsets, face_indices, {id(k, i), id(k + 1, i), id(k + 1, i + 1), id(k, i + 1)});
+            }
+        }
+        for(size_t i = 0 ; i < num_segments ; i++) {
+            AddPolygon(face_offsets, face_indices, {south_pole, id(num_rings - 1, i + 1), id(num_rings - 1, i)});
+        }
+    }
+
+    void Triangulate(std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices) {
+        const size_t num_polygons = face_offsets.size() - 1;
+        size_t num_triangles = 0;
+        for(size_t i = 0 ; i < num_polygons ; i++) {
+            const size_t num_points = face_offsets[i + 1] - face_offsets[i];
+            num_triangles += num_points > 2 ? num_points - 2 : 0;
+        }
+        if(num_triangles == num_polygons) {
+            return;
+        }
+        std::vector<index_t> triangle_offsets, triangle_indices;
+        Clear(triangle_offsets, triangle_indices);
+        triangle_offsets.reserve(num_triangles + 1);
+        triangle_indices.reserve(3 * num_triangles);
+        for(size_t i = 0 ; i < num_polygons ; i++) {
+            const index_t* polygon = face_indices.data() + face_offsets[i];
+            for(index_t j = 1 ; j + 1 < face_offsets[i + 1] - face_offsets[i] ; j++) {
+                AddPolygon(triangle_offsets, triangle_indices, {polygon[0], polygon[j], polygon[j + 1]});
+            }
+        }
+        face_offsets.swap(triangle_offsets);
+        face_indices.swap(triangle_indices);
+    }
+
+    bool Generate(const std::string& spec, std::vector<Eigen::Vector3d>& vertices,
+                  std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices, bool b_triangulate) {
+        std::vector<std::string> tokens;
+        std::stringstream ss(spec);
+        std::string token;
+        while(std::getline(ss, token, ':')) {
+            tokens.emplace_back(token);
+        }
+        if(tokens.size() < 3 || tokens.size() > 4 || tokens[0] != "gen") {
+            std::cerr << "invalid mesh generator " + spec << std::endl;
+            return false;
+        }
+        const std::string& name = tokens[1];
+        const size_t num_faces = std::strtoull(tokens[2].c_str(), nullptr, 10);
+        const bool b_has_param = tokens.size() == 4;
+        const size_t param = b_has_param ? std::strtoull(tokens[3].c_str(), nullptr, 10) : 0;
+
+        if(name == "grid") {
+            QuadGrid(num_faces, vertices, face_offsets, face_indices);
+        } else if(name == "torus") {
+            Torus(num_faces, vertices, face_offsets, face_indices);
+        } else if(name == "icosphere") {
+            Icosphere(num_faces, vertices, face_offsets, face_indices);
+        } else if(name == "random") {
+            RandomPolygonMesh(num_faces, b_has_param ? param : 1, vertices, face_offsets, face_indices);
+        } else if(name == "holes") {
+            GridWithHoles(num_faces, b_has_param ? param : 2, vertices, face_offsets, face_indices);
+        } else if(name == "pole") {
+            PoleSphere(num_faces, b_has_param ? param : 1024, vertices, face_offsets, face_indices);
+        } else {
+            std::cerr << "unknown mesh generator " + name << std::endl;
+            return false;
+        }
+        if(b_triangulate) {
+            Triangulate(face_offsets, face_indices);
+        }
+        return true;
+    }
+}
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+#include "utils/common_utils.h"
+
+namespace SubDivision {
+    using CommonUtils::index_t;
+
+    //Procedural meshes built in memory, the output are the compressed rows `Mesh::SetUp` takes
+    //(polygon i owns face_indices[face_offsets[i], face_offsets[i + 1])), no allocation per face.
+    //Every generator takes the requested number of faces and rounds it to the closest
+    //size its topology allows, so the tests can scale to any input size without files.
+    namespace MeshGenerator {
+
+        //open n_x * n_y grid of quads in the plane z = 0, 4 boundary edges
+        void QuadGrid(size_t num_faces, std::vector<Eigen::Vector3d>& vertices,
+                      std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices);
+
+        //closed torus of quads, every vertex is regular (valence 4)
+        void Torus(size_t num_faces, std::vector<Eigen::Vector3d>& vertices,
+                   std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices);
+
+        //triangles of an icosahedron split 4:1, 20 * 4^k faces with k chosen closest to `num_faces`
+        void Icosphere(size_t num_faces, std::vector<Eigen::Vector3d>& vertices,
+                       std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices);
+
+        //closed torus of triangles, quads, hexagons and octagons chosen at random,
+        //vertex valences vary between 3 and 8
+        void RandomPolygonMesh(size_t num_faces, unsigned int seed, std::vector<Eigen::Vector3d>& vertices,
+                               std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices);
+
+        //quad grid with square holes of `hole_size` * `hole_size` cells, `hole_size + 1` cells apart from each other
+        void GridWithHoles(size_t num_faces, size_t hole_size, std::vector<Eigen::Vector3d>& vertices,
+                           std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices);
+
+        //sphere of quad rings closed by two triangle fans, both poles have valence `pole_valence`
+        void PoleSphere(size_t num_faces, size_t pole_valence, std::vector<Eigen::Vector3d>& vertices,
+                        std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices);
+
+        //split every polygon as a fan from its first point (as `LoadObj` with `b_split_polygon`)
+        void Triangulate(std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices);
+
+        //`spec` is `gen:<name>:<num_faces>[:<param>]` with name in
+        //grid, torus, icosphere, random (param: seed), holes (param: hole size), pole (param: valence)
+        inline bool IsSpec(const std::string& spec) { return spec.compare(0, 4, "gen:") == 0; }
+        bool Generate(const std::string& spec, std::vector<Eigen::Vector3d>& vertices,
+                      std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices, bool b_triangulate = false);
+    }
+}
@@ -0,0 +1,236 @@
+#include "mesh_writer.h"
+#include "utils/thread_pool.h"
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace SubDivision {
+    namespace {
+        const size_t kBlockElements = 1 << 15;  //vertices or faces formatted by one task
+        static_assert(sizeof(index_t) == 4, "PLY faces are written as int lists");
+
+        //RAII `FILE*`, the blocks are large so the stdio buffer is bypassed
+        struct OutputFile {
+            explicit OutputFile(const std::string& file_path) : file(std::fopen(file_path.c_str(), "wb")) {
+                if(file) {
+                    std::setvbuf(file, nullptr, _IONBF, 0);
+                }
+            }
+            ~OutputFile() {
+                if(file) {
+                    std::fclose(file);
+                }
+            }
+            bool Write(const char* data, size_t size) { return std::fwrite(data, 1, size, file) == size; }
+            bool Close() {
+                const bool b_success = std::fclose(file) == 0;
+                file = nullptr;
+                return b_success;
+            }
+            std::FILE* file;
+        };
+
+        //`format(begin, end, buffer)` fills `buffer` with the elements [begin, end). Blocks are
+        //formatted a wave at a time so only `2 * threads` buffers are alive, and written in order.
+        template<typename Format>
+        bool WriteBlocks(OutputFile& file, size_t num_elements, CommonUtils::ThreadPool* pool, const Format& format) {
+            const size_t num_blocks = (num_elements + kBlockElements - 1) / kBlockElements;
+            const size_t wave_size = pool ? 2 * pool->NumThreads() : 1;
+            std::vector<std::string> buffers(wave_size);
+            for(size_t first_block = 0 ; first_block < num_blocks ; first_block += wave_size) {
+                const size_t num_wave_blocks = std::min(wave_size, num_blocks - first_block);
+                auto run = [&](size_t block_begin, size_t block_end) {
+                    for(size_t k = block_begin ; k < block_end ; k++) {
+                        const size_t begin = (first_block + k) * kBlockElements;
+                        format(begin, std::min(num_elements, begin + kBlockElements), buffers[k]);
+                    }
+                };
+                if(pool) {
+                    pool->ParallelFor(0, num_wave_blocks, 1, run);
+                } else {
+                    run(0, num_wave_blocks);
+                }
+                for(size_t k = 0 ; k < num_wave_blocks ; k++) {
+                    if(!file.Write(buffers[k].data(), buffers[k].size())) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        //appenders into a buffer sized for the worst case, `p` moves past the written bytes
+        inline void Put(char*& p, const char* str, size_t size) {
+            std::memcpy(p, str, size);
+            p += size;
+        }
+
+        inline void PutNumber(char*& p, double value) {
+            p = std::to_chars(p, p + 32, value).ptr;  //shortest representation that reads back exactly
+        }
+
+        inline void PutNumber(char*& p, index_t value) {
+            p = std::to_chars(p, p + 16, value).ptr;
+        }
+
+        template<typename T>
+        inline void PutBinary(char*& p, T value) {
+            std::memcpy(p, &value, sizeof(T));  //the supported platforms are little endian
+            p += sizeof(T);
+        }
+
+        bool Fail(const std::string& message, const std::string& file_path) {
+            std::cerr << message + file_path << std::endl;
+            return false;
+        }
+    }
+
+    bool WriteObj(const Mesh& mesh, const std::string& file_path, CommonUtils::ThreadPool* pool) {
+        OutputFile file(file_path);
+        if(!file.file) {
+            return Fail("fail to open file ", file_path);
+        }
+        const auto& vertices = mesh.Vertices();
+        const auto& polygons = mesh.Polygons();
+
+        auto format_vertices = [&vertices](size_t begin, size_t end, std::string& buffer) {
+            buffer.resize((end - begin) * (3 * 32 + 4));
+            char* p = &buffer[0];
+            for(size_t i = begin ; i < end ; i++) {
+                const Eigen::Vector3d& point = vertices[i]->p;
+                Put(p, "v ", 2);
+                PutNumber(p, point.x());
+                *p++ = ' ';
+                PutNumber(p, point.y());
+                *p++ = ' ';
+                PutNumber(p, point.z());
+                *p++ = '\n';
+            }
+            buffer.resize(p - buffer.data());
+        };
+        //a 2-float "uv" channel is written as `vt` records and `v/vt` corners
+        const PrimvarChannel* uv = mesh.FindPrimvar("uv");
+        if(uv && uv->width != 2) {
+            uv = nullptr;
+        }
+        std::vector<size_t> corner_offsets;
+        if(uv && uv->b_face_varying) {
+            corner_offsets.resize(polygons.size() + 1, 0);
+            for(size_t i = 0 ; i < polygons.size() ; i++) {
+                corner_offsets[i + 1] = corner_offsets[i] + polygons[i]->points.size();
+            }
+        }
+        auto format_texcoords = [uv](size_t begin, size_t end, std::string& buffer) {
+            buffer.resize((end - begin) * (2 * 32 + 5));
+            char* p = &buffer[0];
+            for(size_t i = begin ; i < end ; i++) {
+                const float* value = uv->Value(i);
+                Put(p, "vt ", 3);
+                PutNumber(p, static_cast<double>(value[0]));
+                *p++ = ' ';
+                PutNumber(p, static_cast<double>(value[1]));
+                *p++ = '\n';
+            }
+            buffer.resize(p - buffer.data());
+        };
+        auto format_polygons = [&polygons, uv, &corner_offsets](size_t begin, size_t end, std::string& buffer) {
+            size_t max_bytes = 0;
+            for(size_t i = begin ; i < end ; i++) {
+                max_bytes += 3 + (uv ? 32 : 16) * polygons[i]->points.size();
+            }
+            buffer.resize(max_bytes);
+            char* p = &buffer[0];
+            for(size_t i = begin ; i < end ; i++) {
+                *p++ = 'f';
+                const auto& points = polygons[i]->points;
+                for(size_t j = 0 ; j < points.size() ; j++) {
+                    *p++ = ' ';
+                    PutNumber(p, points[j] + 1);  //obj indices start from 1
+                    if(uv) {
+                        *p++ = '/';
+                        PutNumber(p, (uv->b_face_varying ? uv->corner_indices[corner_offsets[i] + j] : points[j]) + 1);
+                    }
+                }
+                *p++ = '\n';
+            }
+            buffer.resize(p - buffer.data());
+        };
+
+        if(!WriteBlocks(file, vertices.size(), pool, format_vertices) ||
+           (uv && !WriteBlocks(file, uv->NumValues(), pool, format_texcoords)) ||
+           !WriteBlocks(file, polygons.size(), pool, format_polygons) || !file.Close()) {
+            return Fail("fail to write file ", file_path);
+        }
+        return true;
+    }
+
+    bool WritePly(const Mesh& mesh, const std::string& file_path, CommonUtils::ThreadPool* pool) {
+        OutputFile file(file_path);
+        if(!file.file) {
+            return Fail("fail to open file ", file_path);
+        }
+        const auto& vertices = mesh.Vertices();
+        const auto& polygons = mesh.Polygons();
+        size_t max_points = 0;
+        for(const auto& polygon : polygons) {
+            max_points = std::max(max_points, polygon->points.size());
+        }
+        const bool b_uchar_count = max_points <= 255;  //the usual `uchar int` list whenever it fits
+
+        const std::string header = "ply\nformat binary_little_endian 1.0\n"
+                                   "element vertex " + std::to_string(vertices.size()) + "\n"
+                                   "property float x\nproperty float y\nproperty float z\n"
+                                   "element face " + std::to_string(polygons.size()) + "\n"
+                                   "property list " + (b_uchar_count ? "uchar" : "int") + " int vertex_indices\n"
+                                   "end_header\n";
+        if(!file.Write(header.data(), header.size())) {
+            return Fail("fail to write file ", file_path);
+        }
+
+        auto format_vertices = [&vertices](size_t begin, size_t end, std::string& buffer) {
+            buffer.resize((end - begin) * 3 * sizeof(float));
+            char* p = &buffer[0];
+            for(size_t i = begin ; i < end ; i++) {
+                const Eigen::Vector3d& point = vertices[i]->p;
+                PutBinary(p, static_cast<float>(point.x()));
+                PutBinary(p, static_cast<float>(point.y()));
+                PutBinary(p, static_cast<float>(point.z()));
+            }
+        };
+        auto format_polygons = [&polygons, b_uchar_count](size_t begin, size_t end, std::string& buffer) {
+            size_t num_bytes = 0;
+            for(size_t i = begin ; i < end ; i++) {
+                num_bytes += (b_uchar_count ? 1 : 4) + 4 * polygons[i]->points.size();
+            }
+            buffer.resize(num_bytes);
+            char* p = &buffer[0];
+            for(size_t i = begin ; i < end ; i++) {
+                const auto& points = polygons[i]->points;
+                if(b_uchar_count) {
+                    PutBinary(p, static_cast<uint8_t>(points.size()));
+                } else {
+                    PutBinary(p, static_cast<int32_t>(points.size()));
+                }
+                Put(p, reinterpret_cast<const char*>(points.data()), points.size() * sizeof(index_t));
+            }
+        };
+
+        if(!WriteBlocks(file, vertices.size(), pool, format_vertices) ||
+           !WriteBlocks(file, polygons.size(), pool, format_polygons) || !file.Close()) {
+            return Fail("fail to write file ", file_path);
+        }
+        return true;
+    }
+
+    bool WriteMesh(const Mesh& mesh, const std::string& file_path, CommonUtils::ThreadPool* pool) {
+        const std::string extension = std::filesystem::path(file_path).extension().string();
+        if(extension == ".ply") {
+            return WritePly(mesh, file_path, pool);
+        }
+        if(extension == ".obj") {
+            return WriteObj(mesh, file_path, pool);
+        }
+        return Fail("unknown mesh format ", file_path);
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "mesh.h"
+#include <string>
+
+namespace CommonUtils {
+    class ThreadPool;
+}
+
+namespace SubDivision {
+
+    //Exporters of refined meshes. Blocks of vertices and faces are formatted in parallel
+    //(`std::to_chars` for OBJ, raw little endian records for PLY) into one buffer per block,
+    //then written in order with one large write per block. `pool`: nullptr formats on the
+    //calling thread. A 2-float primvar channel named "uv" is written as texture coordinates.
+    bool WriteObj(const Mesh& mesh, const std::string& file_path, CommonUtils::ThreadPool* pool = nullptr);
+
+    //binary little endian PLY: float x, y, z per vertex and a `vertex_indices` list per face
+    bool WritePly(const Mesh& mesh, const std::string& file_path, CommonUtils::ThreadPool* pool = nullptr);
+
+    //choose the writer from the extension of `file_path` (.obj or .ply)
+    bool WriteMesh(const Mesh& mesh, const std::string& file_path, CommonUtils::ThreadPool* pool = nullptr);
+}
@@ -0,0 +1,130 @@
+#include "meshlets.h"
+#include "utils/thread_pool.h"
+#include <Eigen/Geometry>
+#include <algorithm>
+
+namespace SubDivision {
+    namespace {
+        const size_t kGrain = 1 << 14;
+        const int kMortonBits = 10;  //per axis
+
+        template<typename Func>
+        inline void ForRange(CommonUtils::ThreadPool* pool, size_t n, size_t grain, const Func& func) {
+            if(pool) {
+                pool->ParallelFor(0, n, grain, func);
+            } else {
+                func(0, n);
+            }
+        }
+
+        //bits of `v` spread to every third bit
+        inline uint32_t SpreadBits(uint32_t v) {
+            v = (v | (v << 16)) & 0x030000ff;
+            v = (v | (v << 8)) & 0x0300f00f;
+            v = (v | (v << 4)) & 0x030c30c3;
+            v = (v | (v << 2)) & 0x09249249;
+            return v;
+        }
+
+        typedef std::pair<uint32_t, uint32_t> TriangleKey;  //(Morton code of the centroid, triangle id)
+    }
+
+    void BuildMeshlets(IndexedTriangles& triangles, std::vector<Meshlet>& meshlets,
+                       size_t max_triangles, CommonUtils::ThreadPool* pool) {
+        meshlets.clear();
+        const size_t num_triangles = triangles.NumIndices() / 3;
+        if(num_triangles == 0) {
+            return;
+        }
+        max_triangles = std::max<size_t>(max_triangles, 1);
+        const float* data = triangles.vertex_data.data();
+        auto position = [data](uint32_t v) { return Eigen::Map<const Eigen::Vector3f>(data + IndexedTriangles::kStride * v); };
+
+        Eigen::Vector3f min_corner = position(triangles.indices[0]), max_corner = min_corner;
+        for(size_t i = 0 ; i < triangles.NumVertices() ; i++) {
+            min_corner = min_corner.cwiseMin(position(i));
+            max_corner = max_corner.cwiseMax(position(i));
+        }
+        const Eigen::Vector3f extent = (max_corner - min_corner).cwiseMax(1e-20f);
+
+        std::vector<TriangleKey> keys(num_triangles);
+        const uint32_t* indices = triangles.indices.data();
+        ForRange(pool, num_triangles, kGrain, [&](size_t triangle_begin, size_t triangle_end) {
+            const float max_cell = static_cast<float>((1 << kMortonBits) - 1);
+            for(size_t t = triangle_begin ; t < triangle_end ; t++) {
+                const Eigen::Vector3f centroid = (position(indices[3 * t]) + position(indices[3 * t + 1]) +
+                                                  position(indices[3 * t + 2])) / 3.0f;
+                const Eigen::Vector3f cell = ((centroid - min_corner).cwiseQuotient(extent) * max_cell).cwiseMax(0.0f).cwiseMin(max_cell);
+                const uint32_t code = SpreadBits(static_cast<uint32_t>(cell(0))) << 2 |
+                                      SpreadBits(static_cast<uint32_t>(cell(1))) << 1 |
+                                      SpreadBits(static_cast<uint32_t>(cell(2)));
+                keys[t] = TriangleKey(code, static_cast<uint32_t>(t));
+            }
+        });
+        if(pool) {
+            pool->ParallelSort(keys);
+        } else {
+            std::sort(keys.begin(), keys.end());
+        }
+
+        std::vector<uint32_t> sorted(triangles.indices.size());
+        ForRange(pool, num_triangles, kGrain, [&](size_t triangle_begin, size_t triangle_end) {
+            for(size_t t = triangle_begin ; t < triangle_end ; t++) {
+                std::copy(indices + 3 * keys[t].second, indices + 3 * keys[t].second + 3, sorted.begin() + 3 * t);
+            }
+        });
+        std::vector<TriangleKey>().swap(keys);
+        triangles.indices.swap(sorted);
+        indices = triangles.indices.data();
+
+        //bounds of every run of `max_triangles`
+        meshlets.resize((num_triangles + max_triangles - 1) / max_triangles);
+        ForRange(pool, meshlets.size(), kGrain / max_triangles + 1, [&](size_t meshlet_begin, size_t meshlet_end) {
+            for(size_t m = meshlet_begin ; m < meshlet_end ; m++) {
+                Meshlet& meshlet = meshlets[m];
+                const size_t first = m * max_triangles, last = std::min(first + max_triangles, num_triangles);
+                meshlet.first_index = static_cast<uint32_t>(3 * first);
+                meshlet.index_count = static_cast<uint32_t>(3 * (last - first));
+
+                Eigen::Vector3f low = position(indices[3 * first]), high = low;
+                Eigen::Vector3f normal_sum = Eigen::Vector3f::Zero();
+                for(size_t c = 3 * first ; c < 3 * last ; c += 3) {
+                    const Eigen::Vector3f p1 = position(indices[c]), p2 = position(indices[c + 1]), p3 = position(indices[c + 2]);
+                    low = low.cwiseMin(p1).cwiseMin(p2).cwiseMin(p3);
+                    high = high.cwiseMax(p1).cwiseMax(p2).cwiseMax(p3);
+                    const Eigen::Vector3f normal = (p2 - p1).cross(p3 - p1);
+                    const float length = normal.norm();
+                    if(length > 0.0f) {
+                        normal_sum += normal / length;
+                    }
+                }
+                const Eigen::Vector3f center = 0.5f * (low + high);
+                float squared_radius = 0.0f;
+                for(size_t c = 3 * first ; c < 3 * last ; c++) {
+                    squared_radius = std::max(squared_radius, (position(indices[c]) - center).squaredNorm());
+                }
+                Eigen::Map<Eigen::Vector3f>(meshlet.center) = center;
+                meshlet.radius = std::sqrt(squared_radius);
+
+                //the axis is the mean unit normal, the cone closes around the farthest normal from it;
+                //a spread of 90 degrees or more can always be seen from somewhere
+                const float sum_length = normal_sum.norm();
+                if(sum_length <= 0.0f) {
+                    continue;
+                }
+                const Eigen::Vector3f axis = normal_sum / sum_length;
+                float min_dot = 1.0f;
+                for(size_t c = 3 * first ; c < 3 * last ; c += 3) {
+                    const Eigen::Vector3f p1 = position(indices[c]);
+                    const Eigen::Vector3f normal = (position(indices[c + 1]) - p1).cross(position(indices[c + 2]) - p1);
+                    const float length = normal.norm();
+                    if(length > 0.0f) {
+                        min_dot = std::min(min_dot, axis.dot(normal) / length);
+                    }
+                }
+                Eigen::Map<Eigen::Vector3f>(meshlet.cone_axis) = axis;
+                meshlet.cone_cutoff = min_dot <= 0.0f ? 1.0f : std::sqrt(1.0f - min_dot * min_dot);
+            }
+        });
+    }
+}
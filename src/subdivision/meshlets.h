@@ -0,0 +1,34 @@
+#pragma once
+#include "indexed_mesh.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace SubDivision {
+
+    //A run of nearby triangles of `IndexedTriangles::indices` with the bounds used to skip it
+    //on the CPU: a bounding sphere for the frustum test and a cone around the triangle normals
+    //for the backface test. All in the space of the vertex records.
+    struct Meshlet {
+        uint32_t first_index = 0;
+        uint32_t index_count = 0;
+        float center[3] = {0.0f, 0.0f, 0.0f};
+        float radius = 0.0f;
+        float cone_axis[3] = {0.0f, 0.0f, 1.0f};
+        float cone_cutoff = 1.0f;  //sine of the largest angle between a normal and the axis, 1: never backfacing
+
+        //every triangle faces away from an eye at `eye`, wherever it is inside the sphere
+        inline bool IsBackfacing(const float* eye) const {
+            const float d[3] = {center[0] - eye[0], center[1] - eye[1], center[2] - eye[2]};
+            const float distance = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+            return d[0] * cone_axis[0] + d[1] * cone_axis[1] + d[2] * cone_axis[2] >= cone_cutoff * distance + radius;
+        }
+    };
+
+    const size_t kMeshletTriangles = 128;
+
+    //sort the triangles of `triangles.indices` along a Morton curve of their centroids and cut them
+    //into meshlets of at most `max_triangles`, `edge_indices` are left as they are
+    void BuildMeshlets(IndexedTriangles& triangles, std::vector<Meshlet>& meshlets,
+                       size_t max_triangles = kMeshletTriangles, CommonUtils::ThreadPool* pool = nullptr);
+}
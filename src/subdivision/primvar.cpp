@@ -0,0 +1,185 @@
+#include "primvar.h"
+#include "mesh.h"
+#include "subdivision_stats.h"
+#include <algorithm>
+
+namespace SubDivision {
+    namespace {
+        //append a zero value to `channel`, returns its index
+        inline index_t AddValue(PrimvarChannel& channel) {
+            channel.values.resize(channel.values.size() + channel.width, 0.0f);
+            return channel.NumValues() - 1;
+        }
+
+        inline void Accumulate(const PrimvarChannel& channel, index_t source, float weight,
+                               PrimvarChannel& refined, index_t target) {
+            const float* in = channel.Value(source);
+            float* out = refined.values.data() + static_cast<size_t>(target) * refined.width;
+            for(int k = 0 ; k < refined.width ; k++) {
+                out[k] += weight * in[k];
+            }
+        }
+
+        //value index of the corner of `polygon_id` at `vertex_id`, -1 if the polygon does not touch it
+        inline index_t CornerValue(const Mesh& mesh, const PrimvarChannel& channel,
+                                   const std::vector<size_t>& corner_offsets, index_t polygon_id, index_t vertex_id) {
+            const auto& points = mesh.PolygonElement(polygon_id)->points;
+            for(size_t k = 0 ; k < points.size() ; k++) {
+                if(points[k] == vertex_id) {
+                    return channel.corner_indices[corner_offsets[polygon_id] + k];
+                }
+            }
+            return -1;
+        }
+
+        //Vertex corners keep the value index of their parent corner, edge points get a new
+        //value per distinct pair of corner values (one for a smooth edge, two across a seam),
+        //face and Doo-Sabin points get one value each.
+        bool RefineFaceVarying(const Mesh& mesh, const PrimvarStencils& stencils, const PrimvarChannel& channel,
+                               const Mesh& refined_mesh, PrimvarChannel& refined) {
+            const auto& polygons = mesh.Polygons();
+            std::vector<size_t> corner_offsets(polygons.size() + 1, 0);
+            for(size_t i = 0 ; i < polygons.size() ; i++) {
+                corner_offsets[i + 1] = corner_offsets[i] + polygons[i]->points.size();
+            }
+            refined.values = channel.values;
+
+            //refined value of each side of an edge, a side is the pair of corner values its faces
+            //see at the edge's ends (both faces see the same pair unless the edge is a seam)
+            struct EdgeSide {
+                index_t value1 = -1;  //value at `Edge::id1`
+                index_t value2 = -1;
+                index_t value = -1;
+            };
+            struct EdgeValue {
+                EdgeSide sides[2];
+            };
+            std::vector<EdgeValue> edge_values(mesh.Edges().size());
+            std::vector<index_t> point_values(stencils.origins.size(), -1);
+
+            const auto& refined_polygons = refined_mesh.Polygons();
+            for(size_t c = 0 ; c < refined_polygons.size() ; c++) {
+                const index_t parent = c < stencils.polygon_parents.size() ? stencils.polygon_parents[c] : -1;
+                for(const auto point_id : refined_polygons[c]->points) {
+                    const PointOrigin& origin = stencils.origins[point_id];
+                    index_t value = point_values[point_id];
+                    if(origin.kind == PointOrigin::kVertex) {
+                        const auto& asso_polygons = mesh.VertexElement(origin.id)->associated_polygons;
+                        const index_t polygon_id = parent >= 0 ? parent : asso_polygons.empty() ? -1 : asso_polygons[0];
+                        value = polygon_id >= 0 ? CornerValue(mesh, channel, corner_offsets, polygon_id, origin.id) : -1;
+                    } else if(origin.kind == PointOrigin::kEdge) {
+                        const std::shared_ptr<Edge>& edge = mesh.EdgeElement(origin.id);
+                        const index_t polygon_id = parent >= 0 ? parent : edge->associated_polygons[0];
+                        const index_t value1 = CornerValue(mesh, channel, corner_offsets, polygon_id, edge->id1);
+                        const index_t value2 = CornerValue(mesh, channel, corner_offsets, polygon_id, edge->id2);
+                        if(value1 < 0 || value2 < 0) {
+                            return false;
+                        }
+                        EdgeValue& edge_value = edge_values[origin.id];
+                        EdgeSide* side = nullptr;
+                        for(auto& s : edge_value.sides) {
+                            if(s.value < 0 || (s.value1 == value1 && s.value2 == value2)) {
+                                side = &s;
+                                break;
+                            }
+                        }
+                        if(side && side->value >= 0) {
+                            value = side->value;
+                        } else {
+                            //a third side only exists around a non-manifold edge, it is not shared
+                            value = AddValue(refined);
+                            Accumulate(channel, value1, 0.5f, refined, value);
+                            Accumulate(channel, value2, 0.5f, refined, value);
+                            if(side) {
+                                *side = EdgeSide{value1, value2, value};
+                            }
+                        }
+                    } else if(value < 0 && origin.kind == PointOrigin::kFace) {
+                        const size_t num_corners = corner_offsets[origin.id + 1] - corner_offsets[origin.id];
+                        value = AddValue(refined);
+                        for(size_t k = corner_offsets[origin.id] ; k < corner_offsets[origin.id + 1] ; k++) {
+                            Accumulate(channel, channel.corner_indices[k], 1.0f / num_corners, refined, value);
+                        }
+                        point_values[point_id] = value;
+                    } else if(value < 0 && origin.kind == PointOrigin::kFaceCorner) {
+                        //the Doo-Sabin stencil only touches the vertices of its face
+                        value = AddValue(refined);
+                        for(index_t s = stencils.offsets[point_id] ; s < stencils.offsets[point_id + 1] ; s++) {
+                            const index_t source = CornerValue(mesh, channel, corner_offsets, origin.id, stencils.sources[s]);
+                            if(source < 0) {
+                                return false;
+                            }
+                            Accumulate(channel, source, stencils.weights[s], refined, value);
+                        }
+                        point_values[point_id] = value;
+                    }
+                    if(value < 0) {
+                        return false;
+                    }
+                    refined.corner_indices.emplace_back(value);
+                }
+            }
+
+            //drop the parent values no corner kept (all of them for Doo-Sabin)
+            std::vector<index_t> remap(refined.NumValues(), -1);
+            for(const auto value : refined.corner_indices) {
+                remap[value] = 0;
+            }
+            index_t num_used = 0;
+            for(size_t i = 0 ; i < remap.size() ; i++) {
+                if(remap[i] >= 0) {
+                    std::copy(refined.Value(i), refined.Value(i) + refined.width,
+                              refined.values.begin() + static_cast<size_t>(num_used) * refined.width);
+                    remap[i] = num_used++;
+                }
+            }
+            refined.values.resize(static_cast<size_t>(num_used) * refined.width);
+            for(auto& value : refined.corner_indices) {
+                value = remap[value];
+            }
+            return true;
+        }
+    }
+
+    size_t PrimvarStencils::MemoryBytes() const {
+        return VectorBytes(origins) + VectorBytes(offsets) + VectorBytes(sources) + VectorBytes(weights) +
+               VectorBytes(polygon_parents);
+    }
+
+    void RefinePrimvars(const Mesh& mesh, const PrimvarStencils& stencils, Mesh& refined_mesh) {
+        const auto& channels = mesh.Primvars();
+        if(channels.empty()) {
+            return;
+        }
+        const size_t num_points = stencils.origins.size();
+        std::vector<PrimvarChannel> refined(channels.size());
+        std::vector<size_t> vertex_channels;
+        for(size_t c = 0 ; c < channels.size() ; c++) {
+            refined[c].name = channels[c].name;
+            refined[c].width = channels[c].width;
+            refined[c].b_face_varying = channels[c].b_face_varying;
+            if(!channels[c].b_face_varying) {
+                refined[c].values.assign(num_points * channels[c].width, 0.0f);
+                vertex_channels.emplace_back(c);
+            }
+        }
+
+        for(size_t i = 0 ; i < num_points ; i++) {
+            for(index_t s = stencils.offsets[i] ; s < stencils.offsets[i + 1] ; s++) {
+                const index_t source = stencils.sources[s];
+                const float weight = stencils.weights[s];
+                for(const auto c : vertex_channels) {
+                    Accumulate(channels[c], source, weight, refined[c], i);
+                }
+            }
+        }
+
+        for(size_t c = 0 ; c < channels.size() ; c++) {
+            if(channels[c].b_face_varying && !RefineFaceVarying(mesh, stencils, channels[c], refined_mesh, refined[c])) {
+                std::cerr << "fail to refine face-varying primvar " + channels[c].name << std::endl;
+                continue;
+            }
+            refined_mesh.AddPrimvar(std::move(refined[c]));
+        }
+    }
+}
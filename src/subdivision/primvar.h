@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "utils/common_utils.h"
+
+namespace SubDivision {
+    using CommonUtils::index_t;
+    class Mesh;
+
+    //Primitive variable (UVs, colours, weights...) of `width` floats per value, stored one
+    //channel after another (structure of arrays).
+    //vertex-varying: one value per vertex, refined with the same stencils as the positions.
+    //face-varying: `corner_indices` holds one value index per polygon corner in the order of
+    //`Polygon::points`, polygons one after another; corners of neighbour faces which do not
+    //share a value index form a seam. Values are interpolated linearly inside every parent
+    //face, so seams stay sharp and values never bleed across them.
+    struct PrimvarChannel {
+        std::string name;
+        int width = 1;
+        bool b_face_varying = false;
+        std::vector<float> values;  //width * number of values
+        std::vector<index_t> corner_indices;  //face-varying only
+
+        inline size_t NumValues() const { return width > 0 ? values.size() / width : 0; }
+        inline const float* Value(index_t i) const { return values.data() + static_cast<size_t>(i) * width; }
+    };
+
+    //what a refined point is made from, `id` indexes the elements of the coarser mesh
+    struct PointOrigin {
+        enum Kind : int { kVertex, kEdge, kFace, kFaceCorner };  //kFaceCorner: Doo-Sabin point inside face `id`
+        Kind kind;
+        index_t id;
+    };
+
+    //How every point and polygon of a refined level is made from the coarser level. The
+    //solvers fill it while they compute the positions, point i of the point table owns
+    //sources/weights [offsets[i], offsets[i + 1]), all weights refer to coarse vertices.
+    struct PrimvarStencils {
+        std::vector<PointOrigin> origins;
+        std::vector<index_t> offsets{0};
+        std::vector<index_t> sources;
+        std::vector<float> weights;
+        std::vector<index_t> polygon_parents;  //coarse polygon of every refined polygon, -1 if it spans several
+
+        void Clear() {
+            origins.clear();
+            offsets.assign(1, 0);
+            sources.clear();
+            weights.clear();
+            polygon_parents.clear();
+        }
+        inline void BeginPoint(const PointOrigin& origin) {
+            origins.emplace_back(origin);
+            offsets.emplace_back(sources.size());
+        }
+        inline void Add(index_t source, double weight) {
+            sources.emplace_back(source);
+            weights.emplace_back(static_cast<float>(weight));
+            offsets.back() = sources.size();
+        }
+        size_t MemoryBytes() const;
+    };
+
+    //Fill the channels of `refined_mesh` from those of `mesh`. Vertex-varying channels are
+    //refined in one loop over the stencils, each stencil is read once for all channels.
+    void RefinePrimvars(const Mesh& mesh, const PrimvarStencils& stencils, Mesh& refined_mesh);
+}
@@ -0,0 +1,208 @@
+#include "smesh_io.h"
+#include <cstring>
+#include <fstream>
+
+namespace SubDivision {
+    namespace {
+        //arrays of one level in file order, filled from the `Mesh` tables
+        struct LevelArrays {
+            std::vector<double> positions;
+            std::vector<index_t> arrays[kSmeshNumArrays];  //`kSmeshPositions` unused
+
+            explicit LevelArrays(const Mesh& mesh) {
+                const auto& vertices = mesh.Vertices();
+                const auto& edges = mesh.Edges();
+                const auto& polygons = mesh.Polygons();
+                positions.reserve(3 * vertices.size());
+                arrays[kSmeshVertexEdgeOffsets].push_back(0);
+                arrays[kSmeshVertexPolygonOffsets].push_back(0);
+                for(const auto& vertex : vertices) {
+                    positions.insert(positions.end(), vertex->p.data(), vertex->p.data() + 3);
+                    Append(vertex->associated_edges, kSmeshVertexEdges, kSmeshVertexEdgeOffsets);
+                    Append(vertex->associated_polygons, kSmeshVertexPolygons, kSmeshVertexPolygonOffsets);
+                }
+                arrays[kSmeshEdgePolygonOffsets].push_back(0);
+                for(const auto& edge : edges) {
+                    arrays[kSmeshEdges].push_back(edge->id1);
+                    arrays[kSmeshEdges].push_back(edge->id2);
+                    Append(edge->associated_polygons, kSmeshEdgePolygons, kSmeshEdgePolygonOffsets);
+                }
+                arrays[kSmeshPolygonOffsets].push_back(0);
+                for(const auto& polygon : polygons) {
+                    Append(polygon->points, kSmeshPolygonPoints, kSmeshPolygonOffsets);
+                    arrays[kSmeshPolygonEdges].insert(arrays[kSmeshPolygonEdges].end(),
+                                                      polygon->edges.begin(), polygon->edges.end());
+                }
+            }
+
+            void Append(const std::vector<index_t>& ids, SmeshArray array, SmeshArray offsets) {
+                arrays[array].insert(arrays[array].end(), ids.begin(), ids.end());
+                arrays[offsets].push_back(arrays[array].size());
+            }
+
+            inline const void* Data(size_t i) const {
+                return i == kSmeshPositions ? static_cast<const void*>(positions.data()) : arrays[i].data();
+            }
+            inline size_t Size(size_t i) const { return i == kSmeshPositions ? positions.size() : arrays[i].size(); }
+        };
+
+        inline uint64_t Align8(uint64_t offset) { return (offset + 7) & ~uint64_t(7); }
+
+        inline size_t ElementBytes(size_t i) { return i == kSmeshPositions ? sizeof(double) : sizeof(index_t); }
+
+        //starts at 0, never decreases and its last entry closes the array it indexes
+        bool ValidOffsets(const index_t* offsets, uint64_t num_elements, uint64_t array_size) {
+            if(offsets[0] != 0 || static_cast<uint64_t>(offsets[num_elements]) != array_size) {
+                return false;
+            }
+            for(uint64_t i = 0 ; i < num_elements ; i++) {
+                if(offsets[i + 1] < offsets[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //every id refers to one of `num_elements` elements
+        bool ValidIds(const index_t* ids, uint64_t size, uint64_t num_elements) {
+            for(uint64_t i = 0 ; i < size ; i++) {
+                if(ids[i] < 0 || static_cast<uint64_t>(ids[i]) >= num_elements) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    bool SaveSmesh(const std::string& file_path, const std::vector<const Mesh*>& levels) {
+        std::ofstream file(file_path, std::ios::binary);
+        if(!file.is_open()) {
+            std::cerr << "fail to open file " + file_path << std::endl;
+            return false;
+        }
+        SmeshHeader header;
+        std::memcpy(header.magic, kSmeshMagic, sizeof(header.magic));
+        header.byte_order = kSmeshByteOrder;
+        header.version = kSmeshVersion;
+        header.num_levels = levels.size();
+        header.reserved = 0;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        //the level table is written last, once the offsets of the arrays are known
+        std::vector<SmeshLevel> table(levels.size());
+        file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SmeshLevel));
+
+        const char padding[8] = {0};
+        uint64_t offset = sizeof(SmeshHeader) + table.size() * sizeof(SmeshLevel);
+        for(size_t l = 0 ; l < levels.size() ; l++) {
+            const LevelArrays arrays(*levels[l]);
+            SmeshLevel& level = table[l];
+            level.num_vertices = levels[l]->Vertices().size();
+            level.num_edges = levels[l]->Edges().size();
+            level.num_polygons = levels[l]->Polygons().size();
+            for(size_t i = 0 ; i < kSmeshNumArrays ; i++) {
+                const uint64_t aligned_offset = Align8(offset);
+                file.write(padding, aligned_offset - offset);
+                const uint64_t num_bytes = arrays.Size(i) * ElementBytes(i);
+                file.write(static_cast<const char*>(arrays.Data(i)), num_bytes);
+                level.offsets[i] = aligned_offset;
+                level.sizes[i] = arrays.Size(i);
+                offset = aligned_offset + num_bytes;
+            }
+        }
+        file.seekp(sizeof(SmeshHeader));
+        file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SmeshLevel));
+        if(!file.good()) {
+            std::cerr << "fail to write file " + file_path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool SmeshFile::Open(const std::string& file_path) {
+        Close();
+        if(!file_.Open(file_path)) {
+            return false;
+        }
+        const char* data = file_.Data();
+        const uint64_t size = file_.Size();
+        SmeshHeader header;
+        if(size < sizeof(header)) {
+            std::cerr << "invalid smesh file " + file_path << std::endl;
+            Close();
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if(std::memcmp(header.magic, kSmeshMagic, sizeof(header.magic)) == 0 && header.byte_order != kSmeshByteOrder) {
+            std::cerr << "smesh file of another byte order " + file_path << std::endl;
+            Close();
+            return false;
+        }
+        if(std::memcmp(header.magic, kSmeshMagic, sizeof(header.magic)) != 0 || header.version != kSmeshVersion ||
+           size < sizeof(header) + header.num_levels * sizeof(SmeshLevel)) {
+            std::cerr << "invalid smesh file (or version) " + file_path << std::endl;
+            Close();
+            return false;
+        }
+
+        const SmeshLevel* table = reinterpret_cast<const SmeshLevel*>(data + sizeof(header));
+        for(uint32_t l = 0 ; l < header.num_levels ; l++) {
+            const SmeshLevel& level = table[l];
+            for(size_t i = 0 ; i < kSmeshNumArrays ; i++) {
+                if(level.offsets[i] % 8 != 0 || level.offsets[i] > size ||
+                   level.sizes[i] > (size - level.offsets[i]) / ElementBytes(i)) {
+                    std::cerr << "truncated smesh file " + file_path << std::endl;
+                    Close();
+                    return false;
+                }
+            }
+            auto ids = [&](SmeshArray i) { return reinterpret_cast<const index_t*>(data + level.offsets[i]); };
+            TopologyView view;
+            view.num_vertices = level.num_vertices;
+            view.num_edges = level.num_edges;
+            view.num_polygons = level.num_polygons;
+            view.positions = reinterpret_cast<const double*>(data + level.offsets[kSmeshPositions]);
+            view.polygon_offsets = ids(kSmeshPolygonOffsets);
+            view.polygon_points = ids(kSmeshPolygonPoints);
+            view.polygon_edges = ids(kSmeshPolygonEdges);
+            view.edges = ids(kSmeshEdges);
+            view.edge_polygon_offsets = ids(kSmeshEdgePolygonOffsets);
+            view.edge_polygons = ids(kSmeshEdgePolygons);
+            view.vertex_edge_offsets = ids(kSmeshVertexEdgeOffsets);
+            view.vertex_edges = ids(kSmeshVertexEdges);
+            view.vertex_polygon_offsets = ids(kSmeshVertexPolygonOffsets);
+            view.vertex_polygons = ids(kSmeshVertexPolygons);
+
+            const uint64_t* sizes = level.sizes;
+            const bool b_valid = sizes[kSmeshPositions] == 3 * level.num_vertices &&
+                                 sizes[kSmeshEdges] == 2 * level.num_edges &&
+                                 sizes[kSmeshPolygonOffsets] == level.num_polygons + 1 &&
+                                 sizes[kSmeshPolygonEdges] == sizes[kSmeshPolygonPoints] &&
+                                 sizes[kSmeshEdgePolygonOffsets] == level.num_edges + 1 &&
+                                 sizes[kSmeshVertexEdgeOffsets] == level.num_vertices + 1 &&
+                                 sizes[kSmeshVertexPolygonOffsets] == level.num_vertices + 1 &&
+                                 ValidOffsets(view.polygon_offsets, level.num_polygons, sizes[kSmeshPolygonPoints]) &&
+                                 ValidOffsets(view.edge_polygon_offsets, level.num_edges, sizes[kSmeshEdgePolygons]) &&
+                                 ValidOffsets(view.vertex_edge_offsets, level.num_vertices, sizes[kSmeshVertexEdges]) &&
+                                 ValidOffsets(view.vertex_polygon_offsets, level.num_vertices, sizes[kSmeshVertexPolygons]) &&
+                                 ValidIds(view.polygon_points, sizes[kSmeshPolygonPoints], level.num_vertices) &&
+                                 ValidIds(view.polygon_edges, sizes[kSmeshPolygonEdges], level.num_edges) &&
+                                 ValidIds(view.edges, sizes[kSmeshEdges], level.num_vertices) &&
+                                 ValidIds(view.edge_polygons, sizes[kSmeshEdgePolygons], level.num_polygons) &&
+                                 ValidIds(view.vertex_edges, sizes[kSmeshVertexEdges], level.num_edges) &&
+                                 ValidIds(view.vertex_polygons, sizes[kSmeshVertexPolygons], level.num_polygons);
+            if(!b_valid) {
+                std::cerr << "inconsistent level " << l << " in smesh file " + file_path << std::endl;
+                Close();
+                return false;
+            }
+            levels_.emplace_back(view);
+        }
+        return true;
+    }
+
+    void SmeshFile::Close() {
+        levels_.clear();
+        file_.Close();
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "mesh.h"
+#include "utils/mapped_file.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SubDivision {
+
+    //Binary mesh container `.smesh`: positions, polygons, the edge table and all adjacency
+    //arrays of `Mesh`, for one or several subdivision levels. Arrays are in the byte order of
+    //the machine that wrote the file (recorded by `byte_order`, a file of the other order is
+    //rejected), 8-byte aligned and addressed by byte offsets, so a mapped file is read in place.
+    //
+    //  SmeshHeader
+    //  SmeshLevel[num_levels]
+    //  arrays of level 0, arrays of level 1, ...
+    const char kSmeshMagic[8] = {'S', 'M', 'E', 'S', 'H', '\0', '\0', '\0'};
+    const uint32_t kSmeshVersion = 2;
+    const uint32_t kSmeshByteOrder = 0x01020304;  //reads 0x04030201 on a machine of the other order
+
+    enum SmeshArray {
+        kSmeshPositions = 0,
+        kSmeshPolygonOffsets,
+        kSmeshPolygonPoints,
+        kSmeshPolygonEdges,
+        kSmeshEdges,
+        kSmeshEdgePolygonOffsets,
+        kSmeshEdgePolygons,
+        kSmeshVertexEdgeOffsets,
+        kSmeshVertexEdges,
+        kSmeshVertexPolygonOffsets,
+        kSmeshVertexPolygons,
+        kSmeshNumArrays
+    };
+
+    struct SmeshHeader {
+        char magic[8];
+        uint32_t byte_order;  //`kSmeshByteOrder`
+        uint32_t version;
+        uint32_t num_levels;
+        uint32_t reserved;  //keeps the level table 8-byte aligned
+    };
+
+    struct SmeshLevel {
+        uint64_t num_vertices;
+        uint64_t num_edges;
+        uint64_t num_polygons;
+        uint64_t offsets[kSmeshNumArrays];  //byte offset of every array from the start of the file
+        uint64_t sizes[kSmeshNumArrays];  //number of elements of every array
+    };
+
+    //`levels[i]` becomes level i, usually the result of subdividing `levels[i - 1]`
+    bool SaveSmesh(const std::string& file_path, const std::vector<const Mesh*>& levels);
+
+    inline bool IsSmeshPath(const std::string& file_path) {
+        return file_path.size() > 6 && file_path.compare(file_path.size() - 6, 6, ".smesh") == 0;
+    }
+
+    //A mapped `.smesh` file, the views stay valid while it is open. `Open` checks every offset
+    //array and every id against the level's element counts, so the views are safe to walk.
+    class SmeshFile {
+    public:
+        bool Open(const std::string& file_path);
+        void Close();
+
+        inline size_t NumLevels() const { return levels_.size(); }
+        inline const TopologyView& Level(size_t level) const { return levels_.at(level); }
+        inline void LoadLevel(size_t level, Mesh& mesh) const { mesh.SetUp(Level(level)); }
+
+    private:
+        CommonUtils::MappedFile file_;
+        std::vector<TopologyView> levels_;
+    };
+}
@@ -0,0 +1,49 @@
+#include "solver_factory.h"
+#include "loop_solver.h"
+#include "catmull_solver.h"
+#include "doo_solver.h"
+#include <algorithm>
+#include <cctype>
+
+namespace SubDivision {
+
+    std::unique_ptr<SubDivisionSolver> CreateSolver(SubdivisionMethod method) {
+        switch(method) {
+            case kLoop:
+                return std::unique_ptr<SubDivisionSolver>(new LoopSolver());
+            case kCatmullClark:
+                return std::unique_ptr<SubDivisionSolver>(new CatmullClarkSolver());
+            case kDooSabin:
+                return std::unique_ptr<SubDivisionSolver>(new DooSabinSolver());
+        }
+        return nullptr;
+    }
+
+    std::string MethodName(SubdivisionMethod method) {
+        switch(method) {
+            case kLoop:
+                return "Loop subdivision";
+            case kCatmullClark:
+                return "Catmull-Clark subdivision";
+            case kDooSabin:
+                return "Doo-Sabin subdivision";
+        }
+        return "Unknown subdivision";
+    }
+
+    bool ParseMethod(const std::string& name, SubdivisionMethod& method) {
+        std::string lower_name(name);
+        std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+        if(lower_name == "loop") {
+            method = kLoop;
+        } else if(lower_name == "catmull" || lower_name == "catmull-clark" || lower_name == "cc") {
+            method = kCatmullClark;
+        } else if(lower_name == "doo" || lower_name == "doo-sabin" || lower_name == "ds") {
+            method = kDooSabin;
+        } else {
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "subdivision_solver.h"
+#include <string>
+
+namespace SubDivision {
+
+    //keep the values consistent to the key selection of the viewer (Z, X, C)
+    enum SubdivisionMethod {
+        kLoop = 0,
+        kCatmullClark = 1,
+        kDooSabin = 2
+    };
+
+    std::unique_ptr<SubDivisionSolver> CreateSolver(SubdivisionMethod method);
+
+    //Loop subdivision only accepts triangles, polygons are split on load
+    inline bool RequiresTriangles(SubdivisionMethod method) { return method == kLoop; }
+
+    std::string MethodName(SubdivisionMethod method);
+
+    //accept "loop", "catmull" (or "catmull-clark", "cc") and "doo" (or "doo-sabin", "ds")
+    bool ParseMethod(const std::string& name, SubdivisionMethod& method);
+}
@@ -44,5 +44,53 @@ namespace SubDivision {
             updated_mesh.SetUp(point_table_, polygons);
         }   
 
+        void SubDivisionSolver::RefinePrimvars(const Mesh& mesh, Mesh& updated_mesh) const {
+            if(b_refine_primvars_) {
+                SubDivision::RefinePrimvars(mesh, stencils_, updated_mesh);
+            }
+        }
 
-}
\ No newline at end of file
+
+        void SubDivisionSolver::BeginStats(const Mesh& mesh, size_t regular_valence, SubdivisionStats* stats) const {
+            if(!stats) {
+                return;
+            }
+            stats->Reset();
+            stats->num_input_vertices = mesh.Vertices().size();
+            stats->num_input_edges = mesh.Edges().size();
+            stats->num_input_polygons = mesh.Polygons().size();
+            for(const auto& vertex : mesh.Vertices()) {
+                const size_t valence = vertex->associated_edges.size();
+                if(valence != vertex->associated_polygons.size()) {
+                    stats->num_boundary_vertices++;
+                } else if(valence != regular_valence) {
+                    stats->num_extraordinary_vertices++;
+                }
+            }
+        }
+
+        void SubDivisionSolver::RecordPhase(const char* name, CommonUtils::Timer& timer, SubdivisionStats* stats) {
+            if(!stats) {
+                return;
+            }
+            const double seconds = timer.ElapsedSeconds();
+            stats->phase_seconds.emplace_back(name, seconds);
+            stats->total_seconds += seconds;
+            timer.Reset();
+        }
+
+        void SubDivisionSolver::EndStats(const Mesh& updated_mesh, size_t scratch_bytes, SubdivisionStats* stats) const {
+            if(!stats) {
+                return;
+            }
+            stats->num_output_vertices = updated_mesh.Vertices().size();
+            stats->num_output_edges = updated_mesh.Edges().size();
+            stats->num_output_polygons = updated_mesh.Polygons().size();
+            stats->num_points_created = point_table_.size();
+            //the table is cleared when a run starts and only grows during it, so its size at the end
+            //is this run's high-water mark (the capacity would add growth slack and earlier runs)
+            stats->peak_point_table_size = point_table_.size();
+            stats->bytes_allocated = scratch_bytes + VectorBytes(point_table_) + stencils_.MemoryBytes() +
+                                     updated_mesh.MemoryBytes();
+        }
+}
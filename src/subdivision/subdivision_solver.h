@@ -1,11 +1,14 @@
 #pragma once
 #include "mesh.h"
+#include "subdivision_stats.h"
 
 
 namespace SubDivision { 
 
     class SubDivisionSolver {
     public:
+        virtual ~SubDivisionSolver() {}
+
         std::vector<Eigen::Vector3d> GetEdgePoints(const Mesh& mesh);
         std::vector<Eigen::Vector3d> GetFacePoints(const Mesh& mesh);
         
@@ -14,6 +17,14 @@ namespace SubDivision {
             point_table_.emplace_back(p);
             return point_table_.size() - 1;
         } 
+        //`origin` and the weights given to `AddStencil` afterwards describe the point for the
+        //primvar channels, they are only recorded when the input mesh has channels
+        inline index_t CreatePoint(const Eigen::Vector3d& p, const PointOrigin& origin) {
+            if(b_refine_primvars_) {
+                stencils_.BeginPoint(origin);
+            }
+            return CreatePoint(p);
+        }
 
         void MakeUpMesh(std::vector<std::vector<index_t>>& polygons,
                         Mesh& updated_mesh); //order polygons in clockwise
@@ -25,10 +36,44 @@ namespace SubDivision {
             }
         }
 
-        virtual bool Run(const Mesh& mesh, Mesh& updated_mesh) = 0;
+        //`stats` is optional, it is filled with the phase times and counts of this run
+        virtual bool Run(const Mesh& mesh, Mesh& updated_mesh, SubdivisionStats* stats = nullptr) = 0;
 
 
     protected:
+        //points of the previous level must not leak into the next one when a solver is reused
+        inline void ResetPointTable() { point_table_.clear(); }
+
+        //start recording stencils if `mesh` carries primvar channels
+        inline void BeginPrimvars(const Mesh& mesh) {
+            stencils_.Clear();
+            b_refine_primvars_ = !mesh.Primvars().empty();
+        }
+        inline bool RefinesPrimvars() const { return b_refine_primvars_; }
+        //weight of coarse vertex `source` in the point created last
+        inline void AddStencil(index_t source, double weight) {
+            if(b_refine_primvars_) {
+                stencils_.Add(source, weight);
+            }
+        }
+        //coarse polygon of the refined polygon added last, -1 if it spans several
+        inline void AddPolygonParent(index_t polygon_id) {
+            if(b_refine_primvars_) {
+                stencils_.polygon_parents.emplace_back(polygon_id);
+            }
+        }
+        //after `MakeUpMesh`: refine the channels of `mesh` into `updated_mesh`
+        void RefinePrimvars(const Mesh& mesh, Mesh& updated_mesh) const;
+
+        //`regular_valence` of an interior vertex: 6 for triangle schemes, 4 for quad schemes
+        void BeginStats(const Mesh& mesh, size_t regular_valence, SubdivisionStats* stats) const;
+        //add the time since the last phase, then restart `timer`
+        static void RecordPhase(const char* name, CommonUtils::Timer& timer, SubdivisionStats* stats);
+        //`scratch_bytes`: intermediate buffers of the scheme, the point table and output mesh are added here
+        void EndStats(const Mesh& updated_mesh, size_t scratch_bytes, SubdivisionStats* stats) const;
+
         std::vector<Eigen::Vector3d> point_table_;
+        PrimvarStencils stencils_;  //stencils_.origins <-> point_table_ (index consistence)
+        bool b_refine_primvars_ = false;
     };
 }
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "subdivision_stats.h"
+#include <iomanip>
+
+namespace SubDivision {
+    void SubdivisionStats::Print(std::ostream& os) const {
+        const std::ios_base::fmtflags flags = os.flags();
+        os<<"vertices "<<num_input_vertices<<" -> "<<num_output_vertices
+          <<", edges "<<num_input_edges<<" -> "<<num_output_edges
+          <<", polygons "<<num_input_polygons<<" -> "<<num_output_polygons<<"\n";
+        os<<"boundary vertices "<<num_boundary_vertices<<", extraordinary vertices "<<num_extraordinary_vertices<<"\n";
+        os<<"points created "<<num_points_created<<", peak point table "<<peak_point_table_size
+          <<", allocated "<<std::fixed<<std::setprecision(2)<<bytes_allocated / (1024.0 * 1024.0)<<" MB\n";
+        for(const auto& phase : phase_seconds) {
+            os<<"  "<<std::left<<std::setw(22)<<phase.first<<std::right<<std::setw(12)
+              <<std::fixed<<std::setprecision(3)<<phase.second * 1e3<<" ms\n";
+        }
+        os<<"  "<<std::left<<std::setw(22)<<"total"<<std::right<<std::setw(12)
+          <<std::fixed<<std::setprecision(3)<<total_seconds * 1e3<<" ms\n";
+        os.flags(flags);
+    }
+}
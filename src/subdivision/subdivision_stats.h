@@ -0,0 +1,46 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "utils/common_utils.h"
+
+namespace SubDivision {
+    using CommonUtils::index_t;
+
+    //What one `SubDivisionSolver::Run` did, filled only if the caller passes a stats object.
+    //`bytes_allocated` is an estimate from the capacities of the solver's buffers and of the
+    //refined mesh, it does not hook the allocator.
+    struct SubdivisionStats {
+        std::vector<std::pair<std::string, double>> phase_seconds;  //in execution order
+        double total_seconds = 0.0;
+
+        size_t num_input_vertices = 0;
+        size_t num_input_edges = 0;
+        size_t num_input_polygons = 0;
+        size_t num_output_vertices = 0;
+        size_t num_output_edges = 0;
+        size_t num_output_polygons = 0;
+
+        size_t num_boundary_vertices = 0;  //of the input mesh
+        size_t num_extraordinary_vertices = 0;  //interior vertices whose valence is not regular for the scheme
+
+        size_t num_points_created = 0;
+        size_t peak_point_table_size = 0;  //most entries the point table held during the run
+        size_t bytes_allocated = 0;
+
+        void Reset() { *this = SubdivisionStats(); }
+        void Print(std::ostream& os = std::cout) const;
+    };
+
+    template<typename T>
+    inline size_t VectorBytes(const std::vector<T>& v) { return v.capacity() * sizeof(T); }
+
+    inline size_t VectorBytes(const std::vector<std::vector<index_t>>& polygons) {
+        size_t bytes = polygons.capacity() * sizeof(std::vector<index_t>);
+        for(const auto& polygon : polygons) {
+            bytes += VectorBytes(polygon);
+        }
+        return bytes;
+    }
+}
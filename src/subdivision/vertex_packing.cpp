@@ -0,0 +1,147 @@
+#include "vertex_packing.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace SubDivision {
+    namespace {
+        const size_t kGrain = 1 << 14;
+
+        inline int16_t ToSnorm16(float value) {
+            return static_cast<int16_t>(std::lround(std::min(std::max(value, -1.0f), 1.0f) * 32767.0f));
+        }
+
+        inline uint32_t ToSnorm10(float value) {
+            const int32_t v = static_cast<int32_t>(std::lround(std::min(std::max(value, -1.0f), 1.0f) * 511.0f));
+            return static_cast<uint32_t>(v) & 0x3ff;
+        }
+
+        //map the unit sphere onto the [-1, 1] square: the upper half is the inner diamond,
+        //the lower half is folded onto the corners
+        inline void EncodeOctahedral(const float* n, int16_t* out) {
+            const float l1 = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]);
+            float x = l1 > 0.0f ? n[0] / l1 : 0.0f;
+            float y = l1 > 0.0f ? n[1] / l1 : 0.0f;
+            if(n[2] < 0.0f) {
+                const float folded_x = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                const float folded_y = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+                x = folded_x;
+                y = folded_y;
+            }
+            out[0] = ToSnorm16(x);
+            out[1] = ToSnorm16(y);
+        }
+    }
+
+    std::string PackedVertexFormat::Name() const {
+        static const char* position_names[] = {"float", "half", "unorm16"};
+        static const char* normal_names[] = {"float", "2_10_10_10", "octahedral"};
+        return std::string("position ") + position_names[position] + ", normal " + normal_names[normal] +
+               ", " + std::to_string(Stride()) + " bytes";
+    }
+
+    uint16_t FloatToHalf(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xff) - 127 + 15;
+        uint32_t mantissa = bits & 0x7fffff;
+        if(((bits >> 23) & 0xff) == 0xff) {
+            return sign | 0x7c00 | (mantissa ? 0x200 : 0);  //inf, nan
+        }
+        if(exponent >= 31) {
+            return sign | 0x7c00;  //overflow
+        }
+        if(exponent <= 0) {
+            if(exponent < -10) {
+                return sign;  //underflow to zero
+            }
+            //subnormal half: shift the implicit leading one in, round to nearest even
+            mantissa |= 0x800000;
+            const int shift = 14 - exponent;
+            uint32_t half_mantissa = mantissa >> shift;
+            const uint32_t remainder = mantissa & ((1u << shift) - 1);
+            const uint32_t halfway = 1u << (shift - 1);
+            if(remainder > halfway || (remainder == halfway && (half_mantissa & 1))) {
+                half_mantissa++;
+            }
+            return sign | static_cast<uint16_t>(half_mantissa);
+        }
+        uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+        const uint32_t remainder = mantissa & 0x1fff;
+        if(remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+            half++;  //may carry into the exponent, which rounds up to the next power of two or inf
+        }
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    void PackVertices(const IndexedTriangles& triangles, const PackedVertexFormat& format,
+                      PackedVertices& packed, CommonUtils::ThreadPool* pool) {
+        packed.data.resize(format.Stride() * triangles.NumVertices());
+        PackVertices(triangles, format, packed.data.data(), packed, pool);
+    }
+
+    void PackVertices(const IndexedTriangles& triangles, const PackedVertexFormat& format,
+                      uint8_t* data, PackedVertices& packed, CommonUtils::ThreadPool* pool) {
+        const size_t num_vertices = triangles.NumVertices();
+        const float* in = triangles.vertex_data.data();
+        const size_t stride = format.Stride();
+        packed.format = format;
+        packed.num_vertices = num_vertices;
+        for(int k = 0 ; k < 3 ; k++) {
+            packed.position_scale[k] = 1.0f;
+            packed.position_offset[k] = 0.0f;
+        }
+
+        if(format.position == kPositionUnorm16 && num_vertices > 0) {
+            for(int k = 0 ; k < 3 ; k++) {
+                float min_value = in[k], max_value = in[k];
+                for(size_t i = 1 ; i < num_vertices ; i++) {
+                    min_value = std::min(min_value, in[IndexedTriangles::kStride * i + k]);
+                    max_value = std::max(max_value, in[IndexedTriangles::kStride * i + k]);
+                }
+                packed.position_offset[k] = min_value;
+                packed.position_scale[k] = max_value > min_value ? max_value - min_value : 1.0f;
+            }
+        }
+
+        auto pack = [&](size_t vertex_begin, size_t vertex_end) {
+            for(size_t i = vertex_begin ; i < vertex_end ; i++) {
+                const float* p = in + IndexedTriangles::kStride * i;
+                const float* n = p + 3;
+                uint8_t* out = data + stride * i;  //every byte of the record is written
+                if(format.position == kPositionFloat) {
+                    std::memcpy(out, p, 3 * sizeof(float));
+                } else {
+                    uint16_t position[4] = {0, 0, 0, 0};
+                    for(int k = 0 ; k < 3 ; k++) {
+                        if(format.position == kPositionHalf) {
+                            position[k] = FloatToHalf(p[k]);
+                        } else {
+                            const float t = (p[k] - packed.position_offset[k]) / packed.position_scale[k];
+                            position[k] = static_cast<uint16_t>(std::lround(std::min(std::max(t, 0.0f), 1.0f) * 65535.0f));
+                        }
+                    }
+                    std::memcpy(out, position, sizeof(position));
+                }
+                out += format.PositionBytes();
+                if(format.normal == kNormalFloat) {
+                    std::memcpy(out, n, 3 * sizeof(float));
+                } else if(format.normal == kNormalInt2101010) {
+                    const uint32_t normal = ToSnorm10(n[0]) | (ToSnorm10(n[1]) << 10) | (ToSnorm10(n[2]) << 20);
+                    std::memcpy(out, &normal, sizeof(normal));
+                } else {
+                    int16_t normal[2];
+                    EncodeOctahedral(n, normal);
+                    std::memcpy(out, normal, sizeof(normal));
+                }
+            }
+        };
+        if(pool) {
+            pool->ParallelFor(0, num_vertices, kGrain, pack);
+        } else {
+            pack(0, num_vertices);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "indexed_mesh.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SubDivision {
+
+    enum PositionFormat {
+        kPositionFloat,    //3 x float, 12 bytes
+        kPositionHalf,     //4 x half float (w unused), 8 bytes
+        kPositionUnorm16,  //4 x unsigned short (w unused) in the bounding box, 8 bytes
+    };
+
+    enum NormalFormat {
+        kNormalFloat,       //3 x float, 12 bytes
+        kNormalInt2101010,  //signed 10 bits per axis, `GL_INT_2_10_10_10_REV`, 4 bytes
+        kNormalOctahedral,  //2 x short, octahedral map of the unit sphere, 4 bytes
+    };
+
+    struct PackedVertexFormat {
+        PositionFormat position = kPositionUnorm16;
+        NormalFormat normal = kNormalOctahedral;
+
+        size_t PositionBytes() const { return position == kPositionFloat ? 12 : 8; }
+        size_t NormalBytes() const { return normal == kNormalFloat ? 12 : 4; }
+        size_t Stride() const { return PositionBytes() + NormalBytes(); }  //normal follows position
+        std::string Name() const;
+    };
+
+    //Vertex records of `IndexedTriangles` in a compact format for the GPU. The shader gets
+    //`position * position_scale + position_offset` back (identity unless the format is unorm16).
+    struct PackedVertices {
+        PackedVertexFormat format;
+        std::vector<uint8_t> data;
+        size_t num_vertices = 0;
+        float position_scale[3] = {1.0f, 1.0f, 1.0f};
+        float position_offset[3] = {0.0f, 0.0f, 0.0f};
+    };
+
+    void PackVertices(const IndexedTriangles& triangles, const PackedVertexFormat& format,
+                      PackedVertices& packed, CommonUtils::ThreadPool* pool = nullptr);
+    //the records written to `data` (`format.Stride()` bytes per vertex), e.g. a mapped vertex buffer,
+    //`packed` only gets the format and the dequantisation
+    void PackVertices(const IndexedTriangles& triangles, const PackedVertexFormat& format,
+                      uint8_t* data, PackedVertices& packed, CommonUtils::ThreadPool* pool = nullptr);
+
+    uint16_t FloatToHalf(float value);
+}
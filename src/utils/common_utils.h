@@ -61,6 +61,14 @@ namespace CommonUtils {
             std::chrono::milliseconds d = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - t0);
             return d.count();
         }
+
+        double ElapsedSeconds() {
+            return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t0).count();
+        }
+
+        void Reset() {
+            t0 = std::chrono::high_resolution_clock::now();
+        }
         std::chrono::time_point<std::chrono::high_resolution_clock> t0;
         //std::chrono::high_resolution_clock::time_point
     };
@@ -9,6 +9,8 @@ struct Config{
     int view_width, view_height;
     std::string vertex_shader_path, fragment_shader_path;
     int maximum_level;
+    std::string frame_log_path;  //CSV with one row per rendered frame, empty: no log
+    bool continuous_rendering = false;  //redraw in every loop iteration (benchmarks), else only when something changed
 
     // bool SetUp(std::string config_path) {
     //     cv::FileStorage fs;
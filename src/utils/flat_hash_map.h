@@ -0,0 +1,218 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace CommonUtils {
+
+    //Hash of `std::string` keys that also takes `const char*` and `std::string_view`, so a
+    //lookup by a C string builds no temporary `std::string` (use it with `std::equal_to<>`).
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view str) const { return std::hash<std::string_view>()(str); }
+    };
+
+    //Open addressing hash map with robin hood probing: slots live in one array of power of two
+    //capacity next to one control word per slot holding the probe distance + 1 in the low byte
+    //(0: empty) and 24 more bits of the hash, so a probe reads a slot only when those match.
+    //An entry displaces richer ones on insertion, so a lookup stops as soon as it meets a slot
+    //closer to its home than the probe, and erasing shifts the following cluster back instead
+    //of leaving tombstones. The table doubles past 7/8 load or when a distance would not fit in
+    //a byte. `Key` and `Value` must be default constructible; no allocation per entry.
+    template<typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+    class FlatHashMap {
+    public:
+        explicit FlatHashMap(size_t capacity = 0) { Reserve(capacity); }
+
+        inline size_t Size() const { return size_; }
+        inline bool Empty() const { return size_ == 0; }
+        inline size_t Capacity() const { return control_.size(); }
+
+        void Clear() {
+            slots_.assign(slots_.size(), Slot());
+            control_.assign(control_.size(), 0);
+            size_ = 0;
+        }
+
+        //room for `num_entries` without growing
+        void Reserve(size_t num_entries) {
+            size_t capacity = kMinCapacity;
+            while(capacity * kMaxLoadNumerator < num_entries * kMaxLoadDenominator) {
+                capacity *= 2;
+            }
+            if(capacity > Capacity()) {
+                Rehash(capacity);
+            }
+        }
+
+        //`K` is `Key` or any type `Hash` and `Equal` take with it, e.g. `const char*` for `StringHash`
+        template<typename K>
+        Value* Find(const K& key) {
+            const size_t index = FindIndex(key, Mix(key));
+            return index == kNotFound ? nullptr : &slots_[index].value;
+        }
+
+        template<typename K>
+        const Value* Find(const K& key) const {
+            const size_t index = FindIndex(key, Mix(key));
+            return index == kNotFound ? nullptr : &slots_[index].value;
+        }
+
+        template<typename K>
+        inline bool Contains(const K& key) const { return FindIndex(key, Mix(key)) != kNotFound; }
+
+        //false, and `value` is dropped, if `key` is already in the map
+        bool Insert(Key key, Value value) {
+            const uint64_t mixed = Mix(key);
+            if(FindIndex(key, mixed) != kNotFound) {
+                return false;
+            }
+            InsertNew(Slot{std::move(key), std::move(value)}, mixed);
+            return true;
+        }
+
+        //the value of `key`, default constructed and inserted if missing
+        Value& operator[](const Key& key) {
+            const uint64_t mixed = Mix(key);
+            size_t index = FindIndex(key, mixed);
+            if(index == kNotFound) {
+                index = InsertNew(Slot{key, Value()}, mixed);
+            }
+            return slots_[index].value;
+        }
+
+        template<typename K>
+        bool Erase(const K& key) {
+            size_t index = FindIndex(key, Mix(key));
+            if(index == kNotFound) {
+                return false;
+            }
+            //backward shift: pull the rest of the cluster one slot closer to home
+            const size_t mask = Capacity() - 1;
+            size_t next = (index + 1) & mask;
+            while((control_[next] & kDistanceMask) > 1) {
+                slots_[index] = std::move(slots_[next]);
+                control_[index] = control_[next] - 1;
+                index = next;
+                next = (next + 1) & mask;
+            }
+            slots_[index] = Slot();
+            control_[index] = 0;
+            size_--;
+            return true;
+        }
+
+        //`func(const Key&, Value&)` for every entry, in slot order
+        template<typename Func>
+        void ForEach(const Func& func) {
+            for(size_t i = 0 ; i < control_.size() ; i++) {
+                if(control_[i]) {
+                    func(static_cast<const Key&>(slots_[i].key), slots_[i].value);
+                }
+            }
+        }
+
+    private:
+        struct Slot {
+            Key key = Key();
+            Value value = Value();
+        };
+
+        static const size_t kMinCapacity = 8;
+        static const size_t kMaxLoadNumerator = 7;
+        static const size_t kMaxLoadDenominator = 8;
+        static const size_t kNotFound = ~size_t(0);
+        static const uint32_t kDistanceMask = 0xff;
+        static const uint32_t kMaxDistance = 0xff;
+
+        //Fibonacci hashing: the top bits of the product mix every bit of the hash, so a weak
+        //hash (e.g. the identity of `std::hash<int>`) still spreads over a power of two table;
+        //they pick the home slot, bits 8 to 31 are the fragment kept in the control word
+        template<typename K>
+        inline uint64_t Mix(const K& key) const {
+            return static_cast<uint64_t>(Hash()(key)) * 0x9E3779B97F4A7C15ull;
+        }
+        inline size_t HomeIndex(uint64_t mixed) const { return static_cast<size_t>(mixed >> shift_); }
+        static inline uint32_t Fragment(uint64_t mixed) { return static_cast<uint32_t>(mixed) & ~kDistanceMask; }
+
+        template<typename K>
+        size_t FindIndex(const K& key, uint64_t mixed) const {
+            if(size_ == 0) {
+                return kNotFound;
+            }
+            const size_t mask = Capacity() - 1;
+            size_t index = HomeIndex(mixed);
+            //a slot matches on its distance and fragment together
+            for(uint32_t control = Fragment(mixed) | 1 ; (control_[index] & kDistanceMask) >= (control & kDistanceMask) ; control++) {
+                if(control_[index] == control && Equal()(slots_[index].key, key)) {
+                    return index;
+                }
+                index = (index + 1) & mask;
+            }
+            return kNotFound;
+        }
+
+        //`slot.key` is not in the map; returns where it ended up
+        size_t InsertNew(Slot slot, uint64_t mixed) {
+            if((size_ + 1) * kMaxLoadDenominator > Capacity() * kMaxLoadNumerator) {
+                Rehash(Capacity() * 2);
+            }
+            const size_t mask = Capacity() - 1;
+            size_t index = HomeIndex(mixed);
+            size_t result = kNotFound;  //of the new entry once it took a slot from a richer one
+            for(uint32_t control = Fragment(mixed) | 1 ; (control & kDistanceMask) < kMaxDistance ; control++, index = (index + 1) & mask) {
+                if(control_[index] == 0) {
+                    slots_[index] = std::move(slot);
+                    control_[index] = control;
+                    size_++;
+                    return result == kNotFound ? index : result;
+                }
+                if((control_[index] & kDistanceMask) < (control & kDistanceMask)) {
+                    //take the slot of the richer entry and carry that one on
+                    std::swap(slots_[index], slot);
+                    std::swap(control_[index], control);
+                    if(result == kNotFound) {
+                        result = index;
+                    }
+                }
+            }
+            //a probe this long means heavy clustering: grow and place the carried entry again
+            const uint64_t carried = Mix(slot.key);
+            if(result == kNotFound) {
+                Rehash(Capacity() * 2);
+                return InsertNew(std::move(slot), carried);
+            }
+            const Key key = slots_[result].key;
+            Rehash(Capacity() * 2);
+            InsertNew(std::move(slot), carried);
+            return FindIndex(key, mixed);
+        }
+
+        void Rehash(size_t capacity) {
+            std::vector<Slot> slots(capacity);
+            std::vector<uint32_t> control(capacity, 0);
+            slots.swap(slots_);
+            control.swap(control_);
+            shift_ = 64;
+            for(size_t c = capacity ; c > 1 ; c >>= 1) {
+                shift_--;
+            }
+            size_ = 0;
+            for(size_t i = 0 ; i < control.size() ; i++) {
+                if(control[i]) {
+                    const uint64_t mixed = Mix(slots[i].key);
+                    InsertNew(std::move(slots[i]), mixed);
+                }
+            }
+        }
+
+        std::vector<Slot> slots_;
+        std::vector<uint32_t> control_;
+        size_t size_ = 0;
+        int shift_ = 64;  //64 - log2(capacity)
+    };
+}
@@ -67,7 +67,7 @@ public:
 			}
 			else
 			{
-				while(mRow < msource.mcapacity && msource.mtable[++mRow] == NULL);
+				while(++mRow < msource.mcapacity && msource.mtable[mRow] == NULL);
 
 
 				if( mRow == msource.mcapacity )
@@ -1,67 +1,200 @@
 #include "io_utils.h"
-//#define DEBUG_INPUT
+#include "mapped_file.h"
+#include "obj_parser.h"
+#include "ply_reader.h"
+#include "thread_pool.h"
+#include <cstring>
 
 namespace CommonUtils {
 bool LoadObj(const std::string& file_path,
                 std::vector<Eigen::Vector3d>& vertices, 
                 std::vector<std::vector<index_t>>& polygons,
-                float b_split_polygon) {
-        std::ifstream file(file_path);
-        if (!file.is_open()) {
-            std::cerr << "fail to open file " + file_path << std::endl;
+                float b_split_polygon, bool b_verbose) {
+        const size_t first_polygon = polygons.size();
+        PolygonObjSink sink(vertices, polygons);
+        if(!ParseObjFile(file_path, sink, b_split_polygon)) {
             return false;
         }
-        std::string type;
-        int face_cnt = 0, vertex_cnt = 0;
-
-
-        while (file >> type) {
-            if (type == "v") {
-                // vertex
-                Eigen::Vector3d vt;
-                file >> vt(0) >> vt(1) >> vt(2);
-                vertices.push_back(vt);
-            } else if (type == "f") {
-                std::string token;
-                std::vector<index_t> index_v;
-                std::string line;
-                getline(file, line);
-                std::stringstream ss(line);
-                while(getline(ss, token, ' '))
-                {
-                    if (token.size() == 0 || token[0] == '\r' || !(token[0] >= '0'&&token[0]<='9') ) continue;
-    #ifdef DEBUG_INPUT
-                    std::cout<<"DEBUG(BCHO): LoadObj(): token:"<<token<<"("<<std::stoi(token) - 1<<")"<<std::endl;
-    #endif
-                    index_v.push_back(std::stoi(token) - 1);
+        if(!b_verbose) {
+            return true;
+        }
+        size_t vertex_cnt = 0;
+        for(size_t i = first_polygon ; i < polygons.size() ; i++) {
+            vertex_cnt += polygons[i].size();
+        }
+        std::cout << "Model has " << polygons.size() - first_polygon << " faces and " << vertex_cnt << " vertexes"
+            << std::endl;
+        return true;
+    }
+
+    namespace {
+        const size_t kObjChunkBytes = 4 << 20;  //small files are parsed on the calling thread
+
+        //vertices and faces of one chunk, face offsets and indices are local to the chunk
+        struct ObjChunk {
+            std::vector<Eigen::Vector3d> vertices;
+            std::vector<index_t> face_offsets;
+            std::vector<index_t> face_indices;
+            size_t num_relative_indices = 0;
+            bool b_success = true;
+
+            void Parse(const char* begin, const char* end, bool b_triangulate, size_t vertex_base) {
+                *this = ObjChunk();
+                CsrObjSink sink(vertices, face_offsets, face_indices);
+                b_success = ParseObj(begin, end, sink, b_triangulate, vertex_base, &num_relative_indices);
+            }
+            inline size_t NumFaces() const { return face_offsets.size() - 1; }
+        };
+
+        template<typename Func>
+        void ForEachChunk(ThreadPool* pool, size_t num_chunks, const Func& func) {
+            auto run = [&func](size_t chunk_begin, size_t chunk_end) {
+                for(size_t i = chunk_begin ; i < chunk_end ; i++) {
+                    func(i);
                 }
+            };
+            if(pool) {
+                pool->ParallelFor(0, num_chunks, 1, run);
+            } else {
+                run(0, num_chunks);
+            }
+        }
+    }
+
+    bool LoadObjMapped(const std::string& file_path,
+                       std::vector<Eigen::Vector3d>& vertices,
+                       std::vector<index_t>& face_offsets,
+                       std::vector<index_t>& face_indices,
+                       bool b_split_polygon, ThreadPool* pool) {
+        MappedFile file;
+        if(!file.Open(file_path)) {
+            return false;
+        }
+        const char* data = file.Data();
+        const size_t size = file.Size();
+
+        std::unique_ptr<ThreadPool> local_pool;
+        if(!pool && size > kObjChunkBytes) {
+            local_pool.reset(new ThreadPool());
+            pool = local_pool.get();
+        }
+        const size_t max_chunks = pool ? pool->NumThreads() * 4 : 1;
+        const size_t num_chunks = std::max<size_t>(1, std::min(max_chunks, size / kObjChunkBytes));
 
-                if (index_v.size() > 2) {
-                    if(b_split_polygon) {
-                        const index_t id0 = index_v[0];
-                        for(int j = 1 ,sz = index_v.size() - 1; j < sz ;j++) {
-                            //push vertex
-                            polygons.emplace_back(std::vector<index_t>{id0, index_v[j], index_v[j+1]});
-                            vertex_cnt += 3;
-                            face_cnt++;
-                        }
-                    }
-                    else {
-                        polygons.push_back(index_v);
-                        vertex_cnt += index_v.size();
-                        face_cnt++;
-                    }
-                    
+        //chunk i is [bounds[i], bounds[i + 1]), every bound but the first follows a newline
+        std::vector<size_t> bounds(num_chunks + 1, size);
+        bounds[0] = 0;
+        for(size_t i = 1 ; i < num_chunks ; i++) {
+            const size_t start = std::max(bounds[i - 1], size / num_chunks * i);
+            const char* eol = static_cast<const char*>(std::memchr(data + start, '\n', size - start));
+            bounds[i] = eol ? eol + 1 - data : size;
+        }
+
+        std::vector<ObjChunk> chunks(num_chunks);
+        ForEachChunk(pool, num_chunks, [&](size_t i) {
+            chunks[i].Parse(data + bounds[i], data + bounds[i + 1], b_split_polygon, 0);
+        });
+
+        //prefix sums give every chunk its place in the merged arrays
+        std::vector<size_t> vertex_offsets(num_chunks + 1, 0), polygon_offsets(num_chunks + 1, 0),
+                            index_offsets(num_chunks + 1, 0);
+        std::vector<size_t> reparsed_chunks;
+        for(size_t i = 0 ; i < num_chunks ; i++) {
+            if(!chunks[i].b_success) {
+                std::cerr << "invalid vertex in file " + file_path << std::endl;
+                return false;
+            }
+            vertex_offsets[i + 1] = vertex_offsets[i] + chunks[i].vertices.size();
+            polygon_offsets[i + 1] = polygon_offsets[i] + chunks[i].NumFaces();
+            index_offsets[i + 1] = index_offsets[i] + chunks[i].face_indices.size();
+            if(i > 0 && chunks[i].num_relative_indices > 0) {
+                reparsed_chunks.emplace_back(i);
+            }
+        }
+        //negative indices were resolved as if the chunk started the file, the vertex
+        //counts are known now, so the (rare) chunks using them are parsed again
+        ForEachChunk(pool, reparsed_chunks.size(), [&](size_t k) {
+            const size_t i = reparsed_chunks[k];
+            chunks[i].Parse(data + bounds[i], data + bounds[i + 1], b_split_polygon, vertex_offsets[i]);
+        });
+
+        const size_t num_vertices = vertex_offsets[num_chunks];
+        vertices.resize(num_vertices);
+        face_offsets.resize(polygon_offsets[num_chunks] + 1);
+        face_indices.resize(index_offsets[num_chunks]);
+        face_offsets.back() = face_indices.size();
+
+        std::atomic<bool> b_valid(true);
+        ForEachChunk(pool, num_chunks, [&](size_t i) {
+            ObjChunk& chunk = chunks[i];
+            std::copy(chunk.vertices.begin(), chunk.vertices.end(), vertices.begin() + vertex_offsets[i]);
+            for(size_t j = 0 ; j < chunk.NumFaces() ; j++) {
+                face_offsets[polygon_offsets[i] + j] = chunk.face_offsets[j] + index_offsets[i];
+            }
+            index_t* ids = face_indices.data() + index_offsets[i];
+            for(const index_t id : chunk.face_indices) {
+                if(id < 0 || static_cast<size_t>(id) >= num_vertices) {
+                    b_valid = false;
                 }
+                *ids++ = id;
             }
+            chunk = ObjChunk();
+        });
+        if(!b_valid) {
+            std::cerr << "face index out of range in file " + file_path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool LoadObjMapped(const std::string& file_path,
+                       std::vector<Eigen::Vector3d>& vertices,
+                       std::vector<std::vector<index_t>>& polygons,
+                       bool b_split_polygon, ThreadPool* pool) {
+        std::vector<index_t> face_offsets, face_indices;
+        if(!LoadObjMapped(file_path, vertices, face_offsets, face_indices, b_split_polygon, pool)) {
+            return false;
+        }
+        polygons.resize(face_offsets.size() - 1);
+        const size_t grain = 1 << 16;
+        auto convert = [&](size_t polygon_begin, size_t polygon_end) {
+            for(size_t i = polygon_begin ; i < polygon_end ; i++) {
+                polygons[i].assign(face_indices.begin() + face_offsets[i], face_indices.begin() + face_offsets[i + 1]);
+            }
+        };
+        if(pool) {
+            pool->ParallelFor(0, polygons.size(), grain, convert);
+        } else {
+            convert(0, polygons.size());
         }
-        file.close();
-    
-        std::cout << "Model has " << face_cnt << " faces and " << vertex_cnt << " vertexes"
-            << std::endl;
         return true;
     }
 
+    inline bool IsPlyPath(const std::string& file_path) {
+        return file_path.size() >= 4 && file_path.compare(file_path.size() - 4, 4, ".ply") == 0;
+    }
+
+    bool LoadMeshFile(const std::string& file_path,
+                      std::vector<Eigen::Vector3d>& vertices,
+                      std::vector<index_t>& face_offsets,
+                      std::vector<index_t>& face_indices,
+                      bool b_split_polygon, ThreadPool* pool) {
+        if(IsPlyPath(file_path)) {
+            return LoadPly(file_path, vertices, face_offsets, face_indices, b_split_polygon);
+        }
+        return LoadObjMapped(file_path, vertices, face_offsets, face_indices, b_split_polygon, pool);
+    }
+
+    bool LoadMeshFile(const std::string& file_path,
+                      std::vector<Eigen::Vector3d>& vertices,
+                      std::vector<std::vector<index_t>>& polygons,
+                      bool b_split_polygon, ThreadPool* pool) {
+        if(IsPlyPath(file_path)) {
+            return LoadPly(file_path, vertices, polygons, b_split_polygon);
+        }
+        return LoadObjMapped(file_path, vertices, polygons, b_split_polygon, pool);
+    }
+
     void *GetFileBuffer(const char *pFileName, int *pBufferSize)
     {
 
@@ -6,10 +6,39 @@
 #include <Eigen/Core>
 
 namespace CommonUtils {
+    //streams the file through `ParseObjFile`, `b_split_polygon` triangulates every face as a fan,
+    //`b_verbose` prints the number of faces and vertices read
     bool LoadObj(const std::string& file_path,
                 std::vector<Eigen::Vector3d>& vertices, 
                 std::vector<std::vector<index_t>>& polygons,
-                float b_split_polygon = false);
+                float b_split_polygon = false, bool b_verbose = true);
+
+    class ThreadPool;
+    //Same output as `LoadObj`, but the file is memory mapped and split into newline aligned
+    //chunks that are parsed in parallel with `std::from_chars`, then the per-chunk arrays are
+    //merged at prefix-summed offsets. Negative (relative) face indices are supported.
+    //`pool`: nullptr creates a temporary pool when the file is larger than one chunk.
+    bool LoadObjMapped(const std::string& file_path,
+                       std::vector<Eigen::Vector3d>& vertices,
+                       std::vector<std::vector<index_t>>& polygons,
+                       bool b_split_polygon = false, ThreadPool* pool = nullptr);
+    //polygons as compressed rows (see `CsrObjSink`), the input of `Mesh::SetUp` without a copy per face
+    bool LoadObjMapped(const std::string& file_path,
+                       std::vector<Eigen::Vector3d>& vertices,
+                       std::vector<index_t>& face_offsets,
+                       std::vector<index_t>& face_indices,
+                       bool b_split_polygon = false, ThreadPool* pool = nullptr);
+
+    //`LoadPly` for *.ply files, `LoadObjMapped` for anything else
+    bool LoadMeshFile(const std::string& file_path,
+                      std::vector<Eigen::Vector3d>& vertices,
+                      std::vector<index_t>& face_offsets,
+                      std::vector<index_t>& face_indices,
+                      bool b_split_polygon = false, ThreadPool* pool = nullptr);
+    bool LoadMeshFile(const std::string& file_path,
+                      std::vector<Eigen::Vector3d>& vertices,
+                      std::vector<std::vector<index_t>>& polygons,
+                      bool b_split_polygon = false, ThreadPool* pool = nullptr);
 
     
     //Read content from file path and return pointer of the buffer
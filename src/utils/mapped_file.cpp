@@ -0,0 +1,46 @@
+#include "mapped_file.h"
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CommonUtils {
+    bool MappedFile::Open(const std::string& file_path) {
+        Close();
+        const int fd = open(file_path.c_str(), O_RDONLY);
+        if(fd < 0) {
+            std::cerr << "fail to open file " + file_path << std::endl;
+            return false;
+        }
+        struct stat file_stat;
+        if(fstat(fd, &file_stat) != 0) {
+            std::cerr << "fail to stat file " + file_path << std::endl;
+            close(fd);
+            return false;
+        }
+        size_ = file_stat.st_size;
+        if(size_ == 0) {  //mmap rejects empty files, an empty view is fine
+            close(fd);
+            return true;
+        }
+        void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);  //the mapping keeps its own reference
+        if(data == MAP_FAILED) {
+            std::cerr << "fail to map file " + file_path << std::endl;
+            size_ = 0;
+            return false;
+        }
+        madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+        return true;
+    }
+
+    void MappedFile::Close() {
+        if(data_) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#ifndef MY_MAPPED_FILE_H
+#define MY_MAPPED_FILE_H
+
+#include <string>
+
+namespace CommonUtils {
+
+    //Read-only memory map of a whole file, unmapped on destruction.
+    class MappedFile {
+    public:
+        MappedFile() : data_(nullptr), size_(0) {}
+        ~MappedFile() { Close(); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const std::string& file_path);
+        void Close();
+
+        inline const char* Data() const { return data_; }
+        inline size_t Size() const { return size_; }
+
+    private:
+        const char* data_;
+        size_t size_;
+    };
+}
+
+#endif
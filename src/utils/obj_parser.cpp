@@ -0,0 +1,144 @@
+#include "obj_parser.h"
+#include "mapped_file.h"
+#include <charconv>
+#include <cstring>
+
+namespace CommonUtils {
+    namespace {
+        inline bool IsBlank(char c) { return c == ' ' || c == '\t'; }
+        inline bool IsSeparator(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+        inline const char* SkipBlanks(const char* p, const char* end) {
+            while(p < end && IsBlank(*p)) {
+                p++;
+            }
+            return p;
+        }
+
+        inline const char* SkipToken(const char* p, const char* end) {
+            while(p < end && !IsSeparator(*p)) {
+                p++;
+            }
+            return p;
+        }
+
+        inline const char* NextLine(const char* p, const char* end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            return eol ? eol + 1 : end;
+        }
+    }
+
+    bool ParseObj(const char* begin, const char* end, ObjSink& sink, bool b_triangulate,
+                  size_t vertex_base, size_t* num_relative_indices) {
+        std::vector<index_t> ids, texcoord_ids;  //reused by every face
+        ids.reserve(16);
+        const bool b_texcoords = sink.WantsTexCoords();
+        size_t num_vertices = vertex_base, num_relative = 0, num_texcoords = 0;
+        for(const char* p = begin ; p < end ; p = NextLine(p, end)) {
+            p = SkipBlanks(p, end);
+            if(b_texcoords && p + 2 < end && p[0] == 'v' && p[1] == 't' && IsBlank(p[2])) {
+                Eigen::Vector2d uv = Eigen::Vector2d::Zero();  //a missing v is 0
+                p += 3;
+                for(int k = 0 ; k < 2 ; k++) {
+                    p = SkipBlanks(p, end);
+                    const std::from_chars_result res = std::from_chars(p, end, uv(k));
+                    if(res.ec != std::errc()) {
+                        if(k == 0) {
+                            return false;
+                        }
+                        break;
+                    }
+                    p = res.ptr;
+                }
+                sink.AddTexCoord(uv);
+                num_texcoords++;
+                continue;
+            }
+            if(p + 1 >= end || !IsBlank(p[1])) {
+                continue;
+            }
+            if(p[0] == 'v') {
+                Eigen::Vector3d vt;
+                p += 2;
+                for(int k = 0 ; k < 3 ; k++) {
+                    p = SkipBlanks(p, end);
+                    const std::from_chars_result res = std::from_chars(p, end, vt(k));
+                    if(res.ec != std::errc()) {
+                        return false;
+                    }
+                    p = res.ptr;
+                }
+                sink.AddVertex(vt);
+                num_vertices++;
+            } else if(p[0] == 'f') {
+                ids.clear();
+                texcoord_ids.clear();
+                p += 2;
+                while(true) {
+                    p = SkipBlanks(p, end);
+                    if(p >= end || *p == '\r' || *p == '\n') {
+                        break;
+                    }
+                    long long id;
+                    const std::from_chars_result res = std::from_chars(p, end, id);
+                    if(res.ec != std::errc()) {  //as the old loader: ignore tokens which are not indices
+                        p = SkipToken(p, end);
+                        continue;
+                    }
+                    if(id < 0) {
+                        id += num_vertices;
+                        num_relative++;
+                    } else {
+                        id -= 1;
+                    }
+                    ids.push_back(static_cast<index_t>(id));
+                    if(b_texcoords) {
+                        long long texcoord_id = 0;
+                        if(res.ptr + 1 < end && res.ptr[0] == '/' &&
+                           std::from_chars(res.ptr + 1, end, texcoord_id).ec == std::errc() && texcoord_id != 0) {
+                            texcoord_id += texcoord_id < 0 ? num_texcoords : -1;
+                        } else {
+                            texcoord_id = -1;  //`v` or `v//vn`
+                        }
+                        texcoord_ids.push_back(static_cast<index_t>(texcoord_id));
+                    }
+                    p = SkipToken(res.ptr, end);  //texture and normal indices of `v/vt/vn`
+                }
+                if(ids.size() <= 2) {
+                    continue;
+                }
+                if(b_triangulate) {
+                    for(size_t j = 1 ; j + 1 < ids.size() ; j++) {
+                        const index_t triangle[3] = {ids[0], ids[j], ids[j + 1]};
+                        sink.AddFace(triangle, 3);
+                        if(b_texcoords) {
+                            const index_t texcoord_triangle[3] = {texcoord_ids[0], texcoord_ids[j], texcoord_ids[j + 1]};
+                            sink.AddFaceTexCoords(texcoord_triangle, 3);
+                        }
+                    }
+                } else {
+                    sink.AddFace(ids.data(), ids.size());
+                    if(b_texcoords) {
+                        sink.AddFaceTexCoords(texcoord_ids.data(), texcoord_ids.size());
+                    }
+                }
+            }
+        }
+        if(num_relative_indices) {
+            *num_relative_indices = num_relative;
+        }
+        return true;
+    }
+
+    bool ParseObjFile(const std::string& file_path, ObjSink& sink, bool b_triangulate) {
+        MappedFile file;
+        if(!file.Open(file_path)) {
+            return false;
+        }
+        if(!ParseObj(file.Data(), file.Data() + file.Size(), sink, b_triangulate)) {
+            std::cerr << "invalid vertex in file " + file_path << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#ifndef MY_OBJ_PARSER_H
+#define MY_OBJ_PARSER_H
+
+#include "common_utils.h"
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+namespace CommonUtils {
+
+    //Receiver of a streamed OBJ file. The parser owns the face buffer, `ids` is only valid
+    //during the call, so sinks decide themselves how (and whether) to allocate.
+    class ObjSink {
+    public:
+        virtual ~ObjSink() {}
+        virtual void AddVertex(const Eigen::Vector3d& p) = 0;
+        virtual void AddFace(const index_t* ids, size_t num_points) = 0;  //0-based vertex ids
+
+        //`vt` records are only parsed for sinks which ask for them
+        virtual bool WantsTexCoords() const { return false; }
+        virtual void AddTexCoord(const Eigen::Vector2d& uv) {}
+        //0-based `vt` ids of the corners of the face added last, -1 for a corner without one
+        virtual void AddFaceTexCoords(const index_t* ids, size_t num_points) {}
+    };
+
+    //Polygons as compressed rows: polygon i is face_indices[face_offsets[i] .. face_offsets[i + 1]).
+    class CsrObjSink : public ObjSink {
+    public:
+        CsrObjSink(std::vector<Eigen::Vector3d>& vertices, std::vector<index_t>& face_offsets,
+                   std::vector<index_t>& face_indices)
+            : vertices_(vertices), face_offsets_(face_offsets), face_indices_(face_indices) {
+            if(face_offsets_.empty()) {
+                face_offsets_.push_back(face_indices_.size());
+            }
+        }
+        void AddVertex(const Eigen::Vector3d& p) override { vertices_.push_back(p); }
+        void AddFace(const index_t* ids, size_t num_points) override {
+            face_indices_.insert(face_indices_.end(), ids, ids + num_points);
+            face_offsets_.push_back(face_indices_.size());
+        }
+
+    private:
+        std::vector<Eigen::Vector3d>& vertices_;
+        std::vector<index_t>& face_offsets_;
+        std::vector<index_t>& face_indices_;
+    };
+
+    //One vector per polygon, the layout `LoadObj` and `Mesh::SetUp` have always used.
+    class PolygonObjSink : public ObjSink {
+    public:
+        PolygonObjSink(std::vector<Eigen::Vector3d>& vertices, std::vector<std::vector<index_t>>& polygons)
+            : vertices_(vertices), polygons_(polygons) {}
+        void AddVertex(const Eigen::Vector3d& p) override { vertices_.push_back(p); }
+        void AddFace(const index_t* ids, size_t num_points) override { polygons_.emplace_back(ids, ids + num_points); }
+
+    private:
+        std::vector<Eigen::Vector3d>& vertices_;
+        std::vector<std::vector<index_t>>& polygons_;
+    };
+
+    //`CsrObjSink` which also keeps the texture coordinates, corner_texcoords[k] <-> face_indices[k].
+    class TexCoordObjSink : public CsrObjSink {
+    public:
+        TexCoordObjSink(std::vector<Eigen::Vector3d>& vertices, std::vector<index_t>& face_offsets,
+                        std::vector<index_t>& face_indices)
+            : CsrObjSink(vertices, face_offsets, face_indices) {}
+        bool WantsTexCoords() const override { return true; }
+        void AddTexCoord(const Eigen::Vector2d& uv) override {
+            texcoords.push_back(static_cast<float>(uv.x()));
+            texcoords.push_back(static_cast<float>(uv.y()));
+        }
+        void AddFaceTexCoords(const index_t* ids, size_t num_points) override {
+            corner_texcoords.insert(corner_texcoords.end(), ids, ids + num_points);
+        }
+        //every corner has a texture coordinate
+        bool HasTexCoords() const {
+            for(const auto id : corner_texcoords) {
+                if(id < 0 || 2 * static_cast<size_t>(id) >= texcoords.size()) {
+                    return false;
+                }
+            }
+            return !corner_texcoords.empty();
+        }
+
+        std::vector<float> texcoords;  //u, v per `vt`
+        std::vector<index_t> corner_texcoords;
+    };
+
+    //Stream `v` and `f` records of [begin, end) into `sink`, other records are skipped
+    //(`vt` and the texture ids of `v/vt/vn` as well, unless `sink.WantsTexCoords()`).
+    //Faces with less than 3 indices are dropped, `b_triangulate` splits the others into a fan
+    //from their first point. Negative face indices are relative to the vertices read so far,
+    //`vertex_base` is the number of vertices before `begin` when a file is parsed in pieces;
+    //`num_relative_indices` (optional) receives how many of them were met.
+    //Returns false on a malformed vertex.
+    bool ParseObj(const char* begin, const char* end, ObjSink& sink, bool b_triangulate = false,
+                  size_t vertex_base = 0, size_t* num_relative_indices = nullptr);
+
+    //memory map `file_path` and stream it into `sink` on the calling thread
+    bool ParseObjFile(const std::string& file_path, ObjSink& sink, bool b_triangulate = false);
+}
+
+#endif
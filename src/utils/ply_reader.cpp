@@ -0,0 +1,375 @@
+#include "ply_reader.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+namespace CommonUtils {
+    namespace {
+        enum PlyType { kPlyInvalid = 0, kPlyInt8, kPlyUint8, kPlyInt16, kPlyUint16, kPlyInt32, kPlyUint32,
+                       kPlyFloat32, kPlyFloat64 };
+
+        PlyType ParsePlyType(const std::string& name) {
+            if(name == "char" || name == "int8") return kPlyInt8;
+            if(name == "uchar" || name == "uint8") return kPlyUint8;
+            if(name == "short" || name == "int16") return kPlyInt16;
+            if(name == "ushort" || name == "uint16") return kPlyUint16;
+            if(name == "int" || name == "int32") return kPlyInt32;
+            if(name == "uint" || name == "uint32") return kPlyUint32;
+            if(name == "float" || name == "float32") return kPlyFloat32;
+            if(name == "double" || name == "float64") return kPlyFloat64;
+            return kPlyInvalid;
+        }
+
+        inline size_t PlyTypeBytes(PlyType type) {
+            static const size_t bytes[] = {0, 1, 1, 2, 2, 4, 4, 4, 8};
+            return bytes[type];
+        }
+
+        //the records are packed, so values are read with memcpy
+        template<typename T>
+        inline T ReadAs(const char* p) {
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            return value;
+        }
+
+        inline double ReadPlyValue(const char* p, PlyType type) {
+            switch(type) {
+                case kPlyInt8: return ReadAs<int8_t>(p);
+                case kPlyUint8: return ReadAs<uint8_t>(p);
+                case kPlyInt16: return ReadAs<int16_t>(p);
+                case kPlyUint16: return ReadAs<uint16_t>(p);
+                case kPlyInt32: return ReadAs<int32_t>(p);
+                case kPlyUint32: return ReadAs<uint32_t>(p);
+                case kPlyFloat32: return ReadAs<float>(p);
+                case kPlyFloat64: return ReadAs<double>(p);
+                default: return 0.0;
+            }
+        }
+
+        inline int64_t ReadPlyInteger(const char* p, PlyType type) {
+            switch(type) {
+                case kPlyInt8: return ReadAs<int8_t>(p);
+                case kPlyUint8: return ReadAs<uint8_t>(p);
+                case kPlyInt16: return ReadAs<int16_t>(p);
+                case kPlyUint16: return ReadAs<uint16_t>(p);
+                case kPlyInt32: return ReadAs<int32_t>(p);
+                case kPlyUint32: return ReadAs<uint32_t>(p);
+                case kPlyFloat32: return static_cast<int64_t>(ReadAs<float>(p));
+                case kPlyFloat64: return static_cast<int64_t>(ReadAs<double>(p));
+                default: return 0;
+            }
+        }
+
+        struct PlyProperty {
+            std::string name;
+            PlyType type = kPlyInvalid;  //value type, index type of a list
+            PlyType count_type = kPlyInvalid;  //kPlyInvalid: not a list
+            inline bool IsList() const { return count_type != kPlyInvalid; }
+        };
+
+        struct PlyElement {
+            std::string name;
+            size_t count = 0;
+            std::vector<PlyProperty> properties;
+
+            //bytes of one record, 0 if it contains a list
+            size_t FixedRecordBytes() const {
+                size_t bytes = 0;
+                for(const auto& property : properties) {
+                    if(property.IsList()) {
+                        return 0;
+                    }
+                    bytes += PlyTypeBytes(property.type);
+                }
+                return bytes;
+            }
+
+            //skip one record starting at `p`, false if it runs past `end`
+            bool SkipRecord(const char*& p, const char* end) const {
+                for(const auto& property : properties) {
+                    size_t bytes = PlyTypeBytes(property.type);
+                    if(property.IsList()) {
+                        if(p + PlyTypeBytes(property.count_type) > end) {
+                            return false;
+                        }
+                        const int64_t count = ReadPlyInteger(p, property.count_type);
+                        p += PlyTypeBytes(property.count_type);
+                        bytes *= count < 0 ? 0 : count;
+                    }
+                    if(p + bytes > end) {
+                        return false;
+                    }
+                    p += bytes;
+                }
+                return true;
+            }
+        };
+
+        //parse the text header, `data_begin` receives the first byte after `end_header\n`
+        bool ParsePlyHeader(const char* data, size_t size, std::vector<PlyElement>& elements,
+                            const char*& data_begin, const std::string& file_path) {
+            const char* header_end = nullptr;
+            for(const char* p = data ; p + 11 <= data + size ; p++) {
+                if(std::memcmp(p, "end_header", 10) == 0 && (p[10] == '\n' || p[10] == '\r')) {
+                    header_end = p + 10;
+                    break;
+                }
+            }
+            if(size < 4 || std::memcmp(data, "ply", 3) != 0 || !header_end) {
+                std::cerr << "invalid ply header in file " + file_path << std::endl;
+                return false;
+            }
+            data_begin = header_end + (header_end[0] == '\r' && header_end + 1 < data + size ? 2 : 1);
+
+            std::stringstream header(std::string(data, header_end));
+            std::string line;
+            bool b_binary_little_endian = false;
+            while(std::getline(header, line)) {
+                std::stringstream ss(line);
+                std::string keyword;
+                ss >> keyword;
+                if(keyword == "format") {
+                    std::string format;
+                    ss >> format;
+                    b_binary_little_endian = format == "binary_little_endian";
+                } else if(keyword == "element") {
+                    PlyElement element;
+                    ss >> element.name >> element.count;
+                    elements.emplace_back(element);
+                } else if(keyword == "property" && !elements.empty()) {
+                    PlyProperty property;
+                    std::string type;
+                    ss >> type;
+                    if(type == "list") {
+                        std::string count_type, index_type;
+                        ss >> count_type >> index_type;
+                        property.count_type = ParsePlyType(count_type);
+                        property.type = ParsePlyType(index_type);
+                        if(property.count_type == kPlyInvalid) {
+                            property.type = kPlyInvalid;
+                        }
+                    } else {
+                        property.type = ParsePlyType(type);
+                    }
+                    ss >> property.name;
+                    if(property.type == kPlyInvalid) {
+                        std::cerr << "unknown ply property type in file " + file_path << std::endl;
+                        return false;
+                    }
+                    elements.back().properties.emplace_back(property);
+                }
+            }
+            if(!b_binary_little_endian) {
+                std::cerr << "only binary_little_endian ply is supported: " + file_path << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        bool ReadPlyVertices(const PlyElement& element, const char*& p, const char* end,
+                             std::vector<Eigen::Vector3d>& vertices) {
+            //byte offset and type of x, y, z inside a record
+            size_t offsets[3] = {0, 0, 0};
+            PlyType types[3] = {kPlyInvalid, kPlyInvalid, kPlyInvalid};
+            size_t offset = 0;
+            for(const auto& property : element.properties) {
+                const int axis = property.name == "x" ? 0 : property.name == "y" ? 1 : property.name == "z" ? 2 : -1;
+                if(axis >= 0 && !property.IsList()) {
+                    offsets[axis] = offset;
+                    types[axis] = property.type;
+                }
+                offset += PlyTypeBytes(property.type);
+            }
+            const size_t record_bytes = element.FixedRecordBytes();
+            if(types[0] == kPlyInvalid || types[1] == kPlyInvalid || types[2] == kPlyInvalid || record_bytes == 0) {
+                return false;
+            }
+            if(static_cast<size_t>(end - p) / record_bytes < element.count) {
+                return false;
+            }
+
+            const size_t first_vertex = vertices.size();
+            vertices.resize(first_vertex + element.count);
+            Eigen::Vector3d* out = vertices.data() + first_vertex;
+            const bool b_leading = offsets[0] == 0 && types[1] == types[0] && types[2] == types[0] &&
+                                   offsets[1] == PlyTypeBytes(types[0]) && offsets[2] == 2 * PlyTypeBytes(types[0]);
+            if(b_leading && types[0] == kPlyFloat64 && record_bytes == 3 * sizeof(double)) {
+                static_assert(sizeof(Eigen::Vector3d) == 3 * sizeof(double), "Eigen::Vector3d is three packed doubles");
+                std::memcpy(out->data(), p, element.count * record_bytes);
+            } else if(b_leading && types[0] == kPlyFloat32) {
+                for(size_t i = 0 ; i < element.count ; i++) {
+                    float xyz[3];
+                    std::memcpy(xyz, p + i * record_bytes, sizeof(xyz));
+                    out[i] = Eigen::Vector3d(xyz[0], xyz[1], xyz[2]);
+                }
+            } else {
+                for(size_t i = 0 ; i < element.count ; i++) {
+                    const char* record = p + i * record_bytes;
+                    out[i] = Eigen::Vector3d(ReadPlyValue(record + offsets[0], types[0]),
+                                             ReadPlyValue(record + offsets[1], types[1]),
+                                             ReadPlyValue(record + offsets[2], types[2]));
+                }
+            }
+            p += element.count * record_bytes;
+            return true;
+        }
+
+        inline void AddPlyFace(const index_t* ids, size_t num_points, bool b_split_polygon,
+                               std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices) {
+            if(num_points <= 2) {
+                return;
+            }
+            if(b_split_polygon) {
+                for(size_t j = 1 ; j + 1 < num_points ; j++) {
+                    face_indices.push_back(ids[0]);
+                    face_indices.push_back(ids[j]);
+                    face_indices.push_back(ids[j + 1]);
+                    face_offsets.push_back(face_indices.size());
+                }
+            } else {
+                face_indices.insert(face_indices.end(), ids, ids + num_points);
+                face_offsets.push_back(face_indices.size());
+            }
+        }
+
+        bool ReadPlyFaces(const PlyElement& element, const char*& p, const char* end, bool b_split_polygon,
+                          std::vector<index_t>& face_offsets, std::vector<index_t>& face_indices) {
+            int list_id = -1;
+            for(size_t i = 0 ; i < element.properties.size() ; i++) {
+                const auto& property = element.properties[i];
+                if(property.IsList() && (property.name == "vertex_indices" || property.name == "vertex_index")) {
+                    list_id = i;
+                }
+            }
+            if(list_id < 0) {
+                return false;
+            }
+            const PlyProperty& list = element.properties[list_id];
+            face_offsets.reserve(face_offsets.size() + element.count);
+            face_indices.reserve(face_indices.size() + 3 * element.count);
+
+            std::vector<index_t> ids;  //reused by every face of the generic path
+            const bool b_fast = element.properties.size() == 1 && list.count_type == kPlyUint8 &&
+                                (list.type == kPlyInt32 || list.type == kPlyUint32);
+            for(size_t i = 0 ; i < element.count ; i++) {
+                if(b_fast) {
+                    if(p >= end) {
+                        return false;
+                    }
+                    const size_t num_points = static_cast<uint8_t>(*p++);
+                    if(static_cast<size_t>(end - p) < num_points * sizeof(index_t)) {
+                        return false;
+                    }
+                    if(!b_split_polygon && num_points > 2) {
+                        const size_t first = face_indices.size();
+                        face_indices.resize(first + num_points);
+                        std::memcpy(face_indices.data() + first, p, num_points * sizeof(index_t));
+                        face_offsets.push_back(face_indices.size());
+                    } else {
+                        ids.resize(num_points);
+                        std::memcpy(ids.data(), p, num_points * sizeof(index_t));
+                        AddPlyFace(ids.data(), num_points, b_split_polygon, face_offsets, face_indices);
+                    }
+                    p += num_points * sizeof(index_t);
+                    continue;
+                }
+                for(size_t k = 0 ; k < element.properties.size() ; k++) {
+                    const PlyProperty& property = element.properties[k];
+                    if(static_cast<int>(k) != list_id) {
+                        PlyElement single;
+                        single.properties.emplace_back(property);
+                        if(!single.SkipRecord(p, end)) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    const size_t count_bytes = PlyTypeBytes(property.count_type);
+                    const size_t index_bytes = PlyTypeBytes(property.type);
+                    if(p + count_bytes > end) {
+                        return false;
+                    }
+                    const int64_t num_points = ReadPlyInteger(p, property.count_type);
+                    p += count_bytes;
+                    if(num_points < 0 || static_cast<size_t>(end - p) < num_points * index_bytes) {
+                        return false;
+                    }
+                    ids.resize(num_points);
+                    for(int64_t j = 0 ; j < num_points ; j++) {
+                        ids[j] = static_cast<index_t>(ReadPlyInteger(p + j * index_bytes, property.type));
+                    }
+                    p += num_points * index_bytes;
+                    AddPlyFace(ids.data(), num_points, b_split_polygon, face_offsets, face_indices);
+                }
+            }
+            return true;
+        }
+    }
+
+    bool LoadPly(const std::string& file_path,
+                 std::vector<Eigen::Vector3d>& vertices,
+                 std::vector<index_t>& face_offsets,
+                 std::vector<index_t>& face_indices,
+                 bool b_split_polygon) {
+        MappedFile file;
+        if(!file.Open(file_path)) {
+            return false;
+        }
+        std::vector<PlyElement> elements;
+        const char* p = nullptr;
+        if(!ParsePlyHeader(file.Data(), file.Size(), elements, p, file_path)) {
+            return false;
+        }
+        const char* end = file.Data() + file.Size();
+
+        vertices.clear();
+        face_offsets.assign(1, 0);
+        face_indices.clear();
+        for(const auto& element : elements) {
+            bool b_success = true;
+            if(element.name == "vertex") {
+                b_success = ReadPlyVertices(element, p, end, vertices);
+            } else if(element.name == "face") {
+                b_success = ReadPlyFaces(element, p, end, b_split_polygon, face_offsets, face_indices);
+            } else {
+                const size_t record_bytes = element.FixedRecordBytes();
+                if(record_bytes > 0) {
+                    b_success = static_cast<size_t>(end - p) / record_bytes >= element.count;
+                    p += b_success ? element.count * record_bytes : 0;
+                } else {
+                    for(size_t i = 0 ; i < element.count && b_success ; i++) {
+                        b_success = element.SkipRecord(p, end);
+                    }
+                }
+            }
+            if(!b_success) {
+                std::cerr << "invalid or truncated ply element " + element.name + " in file " + file_path << std::endl;
+                return false;
+            }
+        }
+
+        for(const auto id : face_indices) {
+            if(id < 0 || static_cast<size_t>(id) >= vertices.size()) {
+                std::cerr << "face index out of range in file " + file_path << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool LoadPly(const std::string& file_path,
+                 std::vector<Eigen::Vector3d>& vertices,
+                 std::vector<std::vector<index_t>>& polygons,
+                 bool b_split_polygon) {
+        std::vector<index_t> face_offsets, face_indices;
+        if(!LoadPly(file_path, vertices, face_offsets, face_indices, b_split_polygon)) {
+            return false;
+        }
+        polygons.resize(face_offsets.size() - 1);
+        for(size_t i = 0 ; i + 1 < face_offsets.size() ; i++) {
+            polygons[i].assign(face_indices.begin() + face_offsets[i], face_indices.begin() + face_offsets[i + 1]);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#ifndef MY_PLY_READER_H
+#define MY_PLY_READER_H
+
+#include "common_utils.h"
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+namespace CommonUtils {
+
+    //Binary little endian PLY reader for `vertex` (x, y, z of any scalar type) and `face`
+    //(`vertex_indices` or `vertex_index` list) elements, other elements and properties are
+    //skipped. The file is memory mapped; vertices whose x, y, z are the leading floats or
+    //doubles of the record and faces made only of a `uchar`-counted `int`/`uint` list are
+    //copied in bulk, other layouts go through a generic per-property path.
+    //Polygons as compressed rows, see `CsrObjSink`.
+    bool LoadPly(const std::string& file_path,
+                 std::vector<Eigen::Vector3d>& vertices,
+                 std::vector<index_t>& face_offsets,
+                 std::vector<index_t>& face_indices,
+                 bool b_split_polygon = false);
+
+    bool LoadPly(const std::string& file_path,
+                 std::vector<Eigen::Vector3d>& vertices,
+                 std::vector<std::vector<index_t>>& polygons,
+                 bool b_split_polygon = false);
+}
+
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <map>
+
+namespace CommonUtils {
+
+    //Sub-allocation of [0, capacity) in units chosen by the caller (e.g. vertices of a buffer):
+    //first fit over the free ranges ordered by offset, a freed range merges with its free
+    //neighbours. The caller owns the storage and grows it with `Grow`.
+    class RangeAllocator {
+    public:
+        explicit RangeAllocator(size_t capacity = 0) { Reset(capacity); }
+
+        inline size_t Capacity() const { return capacity_; }
+        inline size_t FreeSize() const { return free_size_; }
+
+        //everything free again
+        void Reset(size_t capacity) {
+            free_.clear();
+            capacity_ = capacity;
+            free_size_ = capacity;
+            if(capacity > 0) {
+                free_[0] = capacity;
+            }
+        }
+
+        //false if no free range holds `size`; an empty range always succeeds without taking
+        //anything (a level with no vertices or no indices), `Free` of it is a no-op
+        bool Allocate(size_t size, size_t& offset) {
+            if(size == 0) {
+                offset = free_.empty() ? 0 : free_.begin()->first;
+                return true;
+            }
+            for(auto it = free_.begin() ; it != free_.end() ; ++it) {
+                if(it->second >= size) {
+                    offset = it->first;
+                    if(it->second > size) {
+                        free_[offset + size] = it->second - size;
+                    }
+                    free_.erase(it);
+                    free_size_ -= size;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void Free(size_t offset, size_t size) {
+            if(size == 0) {
+                return;
+            }
+            free_size_ += size;
+            auto next = free_.lower_bound(offset);
+            if(next != free_.begin()) {
+                auto previous = std::prev(next);
+                if(previous->first + previous->second == offset) {
+                    offset = previous->first;
+                    size += previous->second;
+                    free_.erase(previous);
+                }
+            }
+            if(next != free_.end() && offset + size == next->first) {
+                size += next->second;
+                free_.erase(next);
+            }
+            free_[offset] = size;
+        }
+
+        //[Capacity(), capacity) becomes free, the allocated ranges stay where they are
+        void Grow(size_t capacity) {
+            if(capacity > capacity_) {
+                const size_t old_capacity = capacity_;
+                capacity_ = capacity;
+                Free(old_capacity, capacity - old_capacity);
+            }
+        }
+
+        //size of the free range that ends at `Capacity()`, a growth for `size` needs only the rest
+        size_t FreeAtEnd() const {
+            if(free_.empty()) {
+                return 0;
+            }
+            auto last = std::prev(free_.end());
+            return last->first + last->second == capacity_ ? last->second : 0;
+        }
+
+    private:
+        std::map<size_t, size_t> free_;  //offset -> size
+        size_t capacity_ = 0;
+        size_t free_size_ = 0;
+    };
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#ifndef MY_SPSC_QUEUE_H
+#define MY_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace CommonUtils {
+
+    //Bounded lock-free queue for exactly one producer thread and one consumer thread.
+    //The producer only writes `tail_`, the consumer only writes `head_`; a slot is published
+    //by the release store of the index and taken over by the acquire load on the other side.
+    template<typename T>
+    class SpscQueue {
+    public:
+        explicit SpscQueue(size_t capacity) : slots_(capacity + 1), head_(0), tail_(0) {}
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        //producer side, false if the queue is full
+        bool Push(T&& value) {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            const size_t next = Next(tail);
+            if(next == head_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            slots_[tail] = std::move(value);
+            tail_.store(next, std::memory_order_release);
+            return true;
+        }
+
+        //consumer side, false if the queue is empty
+        bool Pop(T& value) {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if(head == tail_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            value = std::move(slots_[head]);
+            head_.store(Next(head), std::memory_order_release);
+            return true;
+        }
+
+        //consumer side, only valid while the producer is stopped
+        void Clear() {
+            T value;
+            while(Pop(value)) {
+            }
+        }
+
+    private:
+        inline size_t Next(size_t i) const { return i + 1 == slots_.size() ? 0 : i + 1; }
+
+        std::vector<T> slots_;
+        alignas(64) std::atomic<size_t> head_;  //next slot to pop
+        alignas(64) std::atomic<size_t> tail_;  //next slot to push
+    };
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include "thread_pool.h"
+#include <cassert>
+#include <chrono>
+
+namespace CommonUtils {
+
+    namespace {
+        //identify the pool and the deque owned by the current thread
+        thread_local ThreadPool* tls_pool = nullptr;
+        thread_local size_t tls_queue_index = 0;
+        thread_local size_t tls_task_depth = 0;  //tasks running on the current thread's stack
+    }
+
+    ThreadPool::ThreadPool(size_t num_threads)
+        : num_queued_(0)
+        , num_pending_(0)
+        , next_queue_(0)
+        , b_stop_(false) {
+        if(num_threads == 0) {
+            num_threads = DefaultNumThreads();
+        }
+        queues_.reserve(num_threads);
+        for(size_t i = 0 ; i < num_threads ; i++) {
+            queues_.emplace_back(new WorkQueue());
+        }
+        workers_.reserve(num_threads);
+        for(size_t i = 0 ; i < num_threads ; i++) {
+            workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            b_stop_ = true;
+        }
+        sleep_cv_.notify_all();
+        for(auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::Submit(Task task) {
+        size_t index;
+        if(tls_pool == this) {
+            index = tls_queue_index;
+        } else {
+            index = next_queue_.fetch_add(1) % queues_.size();
+        }
+        num_pending_.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+            queues_[index]->tasks.emplace_back(std::move(task));
+            num_queued_.fetch_add(1);
+        }
+        {
+            //pairs with the predicate check of sleeping workers, no wake-up is lost
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        sleep_cv_.notify_one();
+    }
+
+    void ThreadPool::Wait() {
+        assert(tls_task_depth == 0 && "ThreadPool::Wait() called from inside a task");
+        while(num_pending_.load() > 0) {
+            if(!RunPendingTask()) {
+                std::unique_lock<std::mutex> lock(sleep_mutex_);
+                done_cv_.wait_for(lock, std::chrono::milliseconds(1),
+                                  [this]() { return num_pending_.load() == 0; });
+            }
+        }
+    }
+
+    bool ThreadPool::PopTask(size_t index, Task& task) {
+        {
+            WorkQueue& own = *queues_[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if(!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                num_queued_.fetch_sub(1);
+                return true;
+            }
+        }
+        for(size_t i = 1 ; i < queues_.size() ; i++) {
+            WorkQueue& victim = *queues_[(index + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if(!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                num_queued_.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ThreadPool::RunPendingTask() {
+        if(num_queued_.load() == 0) {
+            return false;
+        }
+        const size_t index = tls_pool == this ? tls_queue_index : next_queue_.load() % queues_.size();
+        Task task;
+        if(!PopTask(index, task)) {
+            return false;
+        }
+        Execute(task);
+        return true;
+    }
+
+    void ThreadPool::Execute(Task& task) {
+        tls_task_depth++;
+        task();
+        tls_task_depth--;
+        task = nullptr;  //release captured state before reporting completion
+        if(num_pending_.fetch_sub(1) == 1) {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex_);
+            }
+            done_cv_.notify_all();
+        }
+    }
+
+    void ThreadPool::WorkerLoop(size_t index) {
+        tls_pool = this;
+        tls_queue_index = index;
+        while(true) {
+            Task task;
+            if(PopTask(index, task)) {
+                Execute(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleep_cv_.wait(lock, [this]() { return b_stop_ || num_queued_.load() > 0; });
+            if(b_stop_ && num_queued_.load() == 0) {
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#ifndef MY_THREAD_POOL_H
+#define MY_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CommonUtils {
+
+    //Work-stealing thread pool.
+    //Every worker owns a deque: a task submitted from a worker is pushed to the back of
+    //its own deque and popped LIFO (the continuation runs hot in cache), idle workers steal
+    //from the front of the other deques. Threads blocked in `Wait()`/`ParallelFor()` help
+    //executing tasks, so `ParallelFor()` may be nested inside a running task.
+    class ThreadPool {
+    public:
+        typedef std::function<void()> Task;
+
+        explicit ThreadPool(size_t num_threads = 0);  // 0: one worker per hardware thread
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void Submit(Task task);
+
+        //block until every submitted task (including tasks submitted by tasks) has finished;
+        //call it from outside the pool only: a running task counts as pending, so a task
+        //waiting for all tasks would wait for itself (use `ParallelFor()` inside tasks)
+        void Wait();
+
+        //split [begin, end) into chunks of `grain` elements and call `func(chunk_begin, chunk_end)`
+        //for every chunk, the calling thread takes part in the work
+        template<typename Func>
+        void ParallelFor(size_t begin, size_t end, size_t grain, const Func& func);
+
+        //sort one block per thread in parallel, then merge pairs of neighbour runs in parallel
+        template<typename T>
+        void ParallelSort(std::vector<T>& values);
+
+        inline size_t NumThreads() const { return workers_.size(); }
+
+        static size_t DefaultNumThreads() {
+            const size_t num_threads = std::thread::hardware_concurrency();
+            return num_threads > 0 ? num_threads : 1;
+        }
+
+    private:
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void WorkerLoop(size_t index);
+        bool PopTask(size_t index, Task& task);  //own queue first, then steal
+        bool RunPendingTask();  //run one queued task on the calling thread if any
+        void Execute(Task& task);
+
+        std::vector<std::unique_ptr<WorkQueue>> queues_;
+        std::vector<std::thread> workers_;
+        std::mutex sleep_mutex_;
+        std::condition_variable sleep_cv_;
+        std::condition_variable done_cv_;
+        std::atomic<size_t> num_queued_;  //tasks waiting in deques
+        std::atomic<size_t> num_pending_;  //tasks submitted and not finished yet
+        std::atomic<size_t> next_queue_;  //round robin for submissions from outside the pool
+        bool b_stop_;
+    };
+
+    template<typename Func>
+    void ThreadPool::ParallelFor(size_t begin, size_t end, size_t grain, const Func& func) {
+        if(begin >= end) {
+            return;
+        }
+        grain = std::max<size_t>(grain, 1);
+        const size_t num_chunks = (end - begin + grain - 1) / grain;
+        if(num_chunks == 1) {
+            func(begin, end);
+            return;
+        }
+
+        std::atomic<size_t> remaining(num_chunks - 1);
+        for(size_t i = 1 ; i < num_chunks ; i++) {
+            const size_t chunk_begin = begin + i * grain;
+            const size_t chunk_end = std::min(end, chunk_begin + grain);
+            Submit([&func, &remaining, chunk_begin, chunk_end]() {
+                func(chunk_begin, chunk_end);
+                remaining.fetch_sub(1);
+            });
+        }
+        func(begin, begin + grain);
+
+        while(remaining.load() > 0) {
+            if(!RunPendingTask()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    template<typename T>
+    void ThreadPool::ParallelSort(std::vector<T>& values) {
+        const size_t n = values.size();
+        size_t width = std::max<size_t>((n + NumThreads() - 1) / NumThreads(), 1);
+        auto begin = values.begin();
+        ParallelFor(0, NumThreads(), 1, [&](size_t block_begin, size_t block_end) {
+            for(size_t b = block_begin ; b < block_end ; b++) {
+                std::sort(begin + std::min(n, b * width), begin + std::min(n, (b + 1) * width));
+            }
+        });
+        for( ; width < n ; width *= 2) {
+            const size_t num_pairs = (n + 2 * width - 1) / (2 * width);
+            ParallelFor(0, num_pairs, 1, [&](size_t pair_begin, size_t pair_end) {
+                for(size_t k = pair_begin ; k < pair_end ; k++) {
+                    std::inplace_merge(begin + 2 * width * k, begin + std::min(n, 2 * width * k + width),
+                                       begin + std::min(n, 2 * width * (k + 1)));
+                }
+            });
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,201 @@
+#include "vertex_weld.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace CommonUtils {
+    namespace {
+        const int kCellBits = 21;  //per axis, three axes packed in one 64-bit key
+        const int64_t kMaxCell = (int64_t(1) << kCellBits) - 1;
+        const size_t kGrain = 1 << 14;
+
+        template<typename Func>
+        inline void ForRange(ThreadPool* pool, size_t n, size_t grain, const Func& func) {
+            if(pool) {
+                pool->ParallelFor(0, n, grain, func);
+            } else {
+                func(0, n);
+            }
+        }
+
+        inline uint64_t CellKey(int64_t x, int64_t y, int64_t z) {
+            return (static_cast<uint64_t>(x) << (2 * kCellBits)) | (static_cast<uint64_t>(y) << kCellBits) |
+                   static_cast<uint64_t>(z);
+        }
+
+        typedef std::pair<uint64_t, index_t> CellEntry;  //(cell key, vertex id)
+    }
+
+    WeldResult WeldVertices(std::vector<Eigen::Vector3d>& vertices,
+                            std::vector<index_t>& face_offsets,
+                            std::vector<index_t>& face_indices,
+                            double tolerance, ThreadPool* pool,
+                            std::vector<index_t>* kept_corners) {
+        WeldResult result;
+        const size_t num_vertices = vertices.size();
+        if(num_vertices == 0 || face_offsets.empty()) {
+            return result;
+        }
+        tolerance = std::max(tolerance, 0.0);
+
+        //cells no smaller than the tolerance keep coincident vertices in neighbour cells,
+        //the lower bound keeps every cell coordinate inside `kCellBits`
+        Eigen::Vector3d min_corner = vertices[0], max_corner = vertices[0];
+        for(const auto& p : vertices) {
+            min_corner = min_corner.cwiseMin(p);
+            max_corner = max_corner.cwiseMax(p);
+        }
+        const double extent = (max_corner - min_corner).maxCoeff();
+        double cell_size = std::max(tolerance, extent / static_cast<double>(kMaxCell - 1));
+        if(cell_size <= 0.0) {
+            cell_size = 1.0;  //every vertex at the same position
+        }
+
+        std::vector<Eigen::Matrix<int64_t, 3, 1>> cells(num_vertices);
+        std::vector<CellEntry> entries(num_vertices);
+        ForRange(pool, num_vertices, kGrain, [&](size_t vertex_begin, size_t vertex_end) {
+            for(size_t i = vertex_begin ; i < vertex_end ; i++) {
+                for(int k = 0 ; k < 3 ; k++) {
+                    const int64_t cell = static_cast<int64_t>(std::floor((vertices[i](k) - min_corner(k)) / cell_size));
+                    cells[i](k) = std::min(std::max<int64_t>(cell, 0), kMaxCell);
+                }
+                entries[i] = CellEntry(CellKey(cells[i](0), cells[i](1), cells[i](2)), static_cast<index_t>(i));
+            }
+        });
+        if(pool) {
+            pool->ParallelSort(entries);
+        } else {
+            std::sort(entries.begin(), entries.end());
+        }
+
+        //smallest vertex id within the tolerance, itself if none is smaller
+        const double squared_tolerance = tolerance * tolerance;
+        std::vector<index_t> targets(num_vertices);
+        ForRange(pool, num_vertices, kGrain, [&](size_t vertex_begin, size_t vertex_end) {
+            for(size_t i = vertex_begin ; i < vertex_end ; i++) {
+                index_t target = static_cast<index_t>(i);
+                for(int64_t dx = -1 ; dx <= 1 ; dx++) {
+                    for(int64_t dy = -1 ; dy <= 1 ; dy++) {
+                        const int64_t x = cells[i](0) + dx, y = cells[i](1) + dy;
+                        if(x < 0 || y < 0 || x > kMaxCell || y > kMaxCell) {
+                            continue;
+                        }
+                        //the cells z - 1, z, z + 1 are consecutive keys, one search covers the three
+                        const uint64_t first_key = CellKey(x, y, std::max<int64_t>(cells[i](2) - 1, 0));
+                        const uint64_t last_key = CellKey(x, y, std::min<int64_t>(cells[i](2) + 1, kMaxCell));
+                        auto it = std::lower_bound(entries.begin(), entries.end(), CellEntry(first_key, 0));
+                        for( ; it != entries.end() && it->first <= last_key ; ++it) {
+                            if(it->second < target && (vertices[it->second] - vertices[i]).squaredNorm() <= squared_tolerance) {
+                                target = it->second;
+                            }
+                        }
+                    }
+                }
+                targets[i] = target;
+            }
+        });
+        std::vector<CellEntry>().swap(entries);
+        std::vector<Eigen::Matrix<int64_t, 3, 1>>().swap(cells);
+
+        //targets point to smaller ids, so one pass in id order resolves chains
+        std::vector<index_t> remap(num_vertices);
+        for(size_t i = 0 ; i < num_vertices ; i++) {
+            if(targets[i] == static_cast<index_t>(i)) {
+                remap[i] = static_cast<index_t>(i);
+            } else {
+                remap[i] = remap[targets[i]];
+                result.num_merged_vertices++;
+            }
+        }
+
+        //two passes over the polygons: remapped sizes, then the compacted rows
+        const size_t num_polygons = face_offsets.size() - 1;
+        std::vector<index_t> new_sizes(num_polygons);
+        auto remap_polygon = [&](size_t i, index_t* out, index_t* out_corners) {
+            index_t size = 0;
+            for(index_t c = face_offsets[i] ; c < face_offsets[i + 1] ; c++) {
+                const index_t v = remap[face_indices[c]];
+                if(size > 0 && out[size - 1] == v) {
+                    continue;
+                }
+                if(out_corners) {
+                    out_corners[size] = c;
+                }
+                out[size++] = v;
+            }
+            while(size > 1 && out[size - 1] == out[0]) {
+                size--;
+            }
+            for(index_t a = 0 ; a < size && size >= 3 ; a++) {
+                for(index_t b = a + 1 ; b < size ; b++) {
+                    if(out[a] == out[b]) {
+                        return index_t(0);
+                    }
+                }
+            }
+            return size >= 3 ? size : index_t(0);
+        };
+        ForRange(pool, num_polygons, kGrain, [&](size_t polygon_begin, size_t polygon_end) {
+            std::vector<index_t> scratch;
+            for(size_t i = polygon_begin ; i < polygon_end ; i++) {
+                scratch.resize(face_offsets[i + 1] - face_offsets[i]);
+                new_sizes[i] = remap_polygon(i, scratch.data(), nullptr);
+            }
+        });
+
+        std::vector<index_t> new_offsets(1, 0);
+        new_offsets.reserve(num_polygons + 1);
+        std::vector<index_t> polygon_starts(num_polygons);  //start of each kept polygon in the new rows
+        for(size_t i = 0 ; i < num_polygons ; i++) {
+            polygon_starts[i] = new_offsets.back();
+            if(new_sizes[i] > 0) {
+                new_offsets.emplace_back(new_offsets.back() + new_sizes[i]);
+            }
+        }
+        result.num_dropped_polygons = num_polygons - (new_offsets.size() - 1);
+        std::vector<index_t> new_indices(new_offsets.back());
+        if(kept_corners) {
+            kept_corners->resize(new_indices.size());
+        }
+        ForRange(pool, num_polygons, kGrain, [&](size_t polygon_begin, size_t polygon_end) {
+            std::vector<index_t> scratch, scratch_corners;
+            for(size_t i = polygon_begin ; i < polygon_end ; i++) {
+                if(new_sizes[i] == 0) {
+                    continue;
+                }
+                scratch.resize(face_offsets[i + 1] - face_offsets[i]);
+                scratch_corners.resize(scratch.size());
+                remap_polygon(i, scratch.data(), scratch_corners.data());
+                std::copy(scratch.begin(), scratch.begin() + new_sizes[i], new_indices.begin() + polygon_starts[i]);
+                if(kept_corners) {
+                    std::copy(scratch_corners.begin(), scratch_corners.begin() + new_sizes[i],
+                              kept_corners->begin() + polygon_starts[i]);
+                }
+            }
+        });
+
+        //keep the vertices still used by a polygon, in their original order
+        std::vector<index_t> compact(num_vertices, -1);
+        for(const auto v : new_indices) {
+            compact[v] = 0;
+        }
+        index_t num_kept = 0;
+        for(size_t i = 0 ; i < num_vertices ; i++) {
+            if(compact[i] >= 0) {
+                vertices[num_kept] = vertices[i];
+                compact[i] = num_kept++;
+            }
+        }
+        vertices.resize(num_kept);
+        result.num_unreferenced_vertices = num_vertices - result.num_merged_vertices - num_kept;
+        ForRange(pool, new_indices.size(), kGrain, [&](size_t corner_begin, size_t corner_end) {
+            for(size_t c = corner_begin ; c < corner_end ; c++) {
+                new_indices[c] = compact[new_indices[c]];
+            }
+        });
+        face_offsets = std::move(new_offsets);
+        face_indices = std::move(new_indices);
+        return result;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#ifndef MY_VERTEX_WELD_H
+#define MY_VERTEX_WELD_H
+
+#include "common_utils.h"
+#include <vector>
+#include <Eigen/Core>
+
+namespace CommonUtils {
+    class ThreadPool;
+
+    struct WeldResult {
+        size_t num_merged_vertices = 0;
+        size_t num_unreferenced_vertices = 0;  //removed, e.g. left over by dropped polygons
+        size_t num_dropped_polygons = 0;
+    };
+
+    //Merge vertices closer than `tolerance` (0: identical positions only) so that seams and
+    //panel boundaries of the input share their vertices before `Mesh::SetUp`. Positions are
+    //hashed into a grid of cells of size `tolerance`, each vertex is merged into the smallest
+    //vertex id found in the 27 neighbour cells. Polygons are remapped, repeated consecutive
+    //corners are collapsed and polygons left with less than 3 corners or a repeated vertex are
+    //dropped, then vertices no polygon uses are removed. Polygons as compressed rows, see
+    //`CsrObjSink`. `pool`: nullptr runs on the calling thread. `kept_corners`: if not null,
+    //receives the old corner index of every remaining corner, e.g. to compact face-varying
+    //data the same way.
+    WeldResult WeldVertices(std::vector<Eigen::Vector3d>& vertices,
+                            std::vector<index_t>& face_offsets,
+                            std::vector<index_t>& face_indices,
+                            double tolerance, ThreadPool* pool = nullptr,
+                            std::vector<index_t>* kept_corners = nullptr);
+}
+
+#endif
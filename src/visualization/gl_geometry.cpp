@@ -1,4 +1,5 @@
 #include "gl_geometry.h"
+#include <algorithm>
 
 namespace GLRendering{
     Geometry::Geometry()
@@ -61,6 +62,7 @@ namespace GLRendering{
 
     void Geometry::Destroy()
     {
+        GL(glDeleteVertexArrays( 1, &vao_id_ ));
         GL(glDeleteBuffers( 1, &ib_id_ ));
         GL(glDeleteBuffers( 1, &vb_id_ ));
 
@@ -108,4 +110,240 @@ namespace GLRendering{
         GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
     }
+
+    namespace {
+        const size_t kMinArenaVertices = size_t(1) << 16;
+        const size_t kMinArenaIndices = size_t(1) << 18;
+    }
+
+    GeometryArena::GeometryArena()
+        : vb_id_(0)
+        , ib_id_(0)
+        , vao_id_(0)
+        , vertex_size_(0)
+        , mapped_vertices_(nullptr)
+        , mapped_indices_(nullptr)
+        , persistent_(false)
+        , persistent_vertices_(nullptr)
+        , persistent_indices_(nullptr)
+        , fence_(0)
+    {
+
+    }
+
+    void GeometryArena::Initialize(const ProgramAttribute* pAttribs, int nAttribs, int vertexSize)
+    {
+        persistent_ = GLEW_ARB_buffer_storage;
+        attribs_.assign(pAttribs, pAttribs + nAttribs);
+        vertex_size_ = vertexSize;
+        vertices_.Reset(0);
+        indices_.Reset(0);
+        GL(glGenBuffers( 1, &vb_id_));
+        GL(glGenBuffers( 1, &ib_id_));
+        GL(glGenVertexArrays( 1, &vao_id_ ));
+        BindVertexArray();
+    }
+
+    void GeometryArena::BindVertexArray()
+    {
+        //the attribute pointers keep the buffer bound when they are set, so this runs again
+        //whenever the vertex buffer is replaced by a larger one
+        GL(glBindVertexArray( vao_id_ ));
+        GL(glBindBuffer( GL_ARRAY_BUFFER, vb_id_ ));
+        for(size_t i = 0; i < attribs_.size(); i++)
+        {
+            GL(glEnableVertexAttribArray( attribs_[i].index ));
+            GL(glVertexAttribPointer(attribs_[i].index, attribs_[i].size,
+                attribs_[i].type, attribs_[i].normalized,
+                attribs_[i].stride, (void*)(unsigned long long)(attribs_[i].offset)));
+        }
+        GL(glBindBuffer( GL_ARRAY_BUFFER, 0));
+        GL(glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ib_id_));
+        GL(glBindVertexArray( 0 ));
+    }
+
+    bool GeometryArena::Allocate(GLenum target, unsigned int& bufferId, void*& persistentData, CommonUtils::RangeAllocator& allocator,
+                                 size_t elementSize, size_t count, size_t& offset)
+    {
+        if(allocator.Allocate(count, offset)) {
+            return true;
+        }
+        const size_t oldCapacity = allocator.Capacity();
+        const size_t capacity = std::max(std::max(2 * oldCapacity, oldCapacity + count - allocator.FreeAtEnd()),
+                                         target == GL_ARRAY_BUFFER ? kMinArenaVertices : kMinArenaIndices);
+        unsigned int newBufferId = 0;
+        GL(glGenBuffers( 1, &newBufferId));
+        GL(glBindBuffer( GL_COPY_WRITE_BUFFER, newBufferId));
+        //immutable storage, coherent so the writes need no flush before the draws
+        const GLbitfield persistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        if(persistent_) {
+            GL(glBufferStorage( GL_COPY_WRITE_BUFFER, capacity * elementSize, NULL, persistentFlags));
+        } else {
+            GL(glBufferData( GL_COPY_WRITE_BUFFER, capacity * elementSize, NULL, GL_STATIC_DRAW));
+        }
+        if(glGetError() == GL_OUT_OF_MEMORY) {
+            GL(glBindBuffer( GL_COPY_WRITE_BUFFER, 0));
+            GL(glDeleteBuffers( 1, &newBufferId));
+            return false;
+        }
+        if(oldCapacity > 0) {
+            //the resident ranges keep their offsets, the copy stays on the GPU
+            GL(glBindBuffer( GL_COPY_READ_BUFFER, bufferId));
+            GL(glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldCapacity * elementSize));
+            GL(glBindBuffer( GL_COPY_READ_BUFFER, 0));
+        }
+        void* newData = nullptr;
+        if(persistent_) {
+            newData = glMapBufferRange( GL_COPY_WRITE_BUFFER, 0, capacity * elementSize, persistentFlags);
+        }
+        GL(glBindBuffer( GL_COPY_WRITE_BUFFER, 0));
+        if(persistent_ && !newData) {
+            GL(glDeleteBuffers( 1, &newBufferId));
+            return false;
+        }
+        //deleting the old buffer also unmaps it
+        GL(glDeleteBuffers( 1, &bufferId));
+        persistentData = newData;
+        FenceDraws();  //the new range may overlap the copy, it is written once the copy is done
+        bufferId = newBufferId;
+        BindVertexArray();
+        allocator.Grow(capacity);
+        return allocator.Allocate(count, offset);
+    }
+
+    bool GeometryArena::BeginUpload(int nVertices, int nIndices, int nLineIndices, ArenaRange& range)
+    {
+        size_t vertexOffset = 0, indexOffset = 0;
+        if(!Allocate(GL_ARRAY_BUFFER, vb_id_, persistent_vertices_, vertices_, vertex_size_, nVertices, vertexOffset)) {
+            return false;
+        }
+        if(!Allocate(GL_ELEMENT_ARRAY_BUFFER, ib_id_, persistent_indices_, indices_, sizeof(unsigned int),
+                     nIndices + nLineIndices, indexOffset)) {
+            vertices_.Free(vertexOffset, nVertices);
+            return false;
+        }
+        range.baseVertex = (int)vertexOffset;
+        range.numVertices = nVertices;
+        range.firstIndex = indexOffset;
+        range.numIndices = nIndices;
+        range.numLineIndices = nLineIndices;
+
+        if(persistent_) {
+            WaitForDraws();
+            mapped_vertices_ = (char*)persistent_vertices_ + vertexOffset * vertex_size_;
+            mapped_indices_ = (unsigned int*)persistent_indices_ + indexOffset;
+            return true;
+        }
+        //only the new range is invalidated, draws of the others go on; the element buffer is
+        //bound with no vertex array bound so none of them changes. An empty range is not mapped
+        //(a zero length is an error), its pointer stays null
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+        GL(glBindVertexArray( 0 ));
+        if(nVertices > 0) {
+            GL(glBindBuffer( GL_ARRAY_BUFFER, vb_id_ ));
+            mapped_vertices_ = glMapBufferRange( GL_ARRAY_BUFFER, vertexOffset * vertex_size_, (size_t)nVertices * vertex_size_, flags);
+            GL(glBindBuffer( GL_ARRAY_BUFFER, 0));
+        }
+        if(nIndices + nLineIndices > 0) {
+            GL(glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ib_id_ ));
+            mapped_indices_ = (unsigned int*)glMapBufferRange( GL_ELEMENT_ARRAY_BUFFER, indexOffset * sizeof(unsigned int),
+                                                               (size_t)(nIndices + nLineIndices) * sizeof(unsigned int), flags);
+            GL(glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0));
+        }
+        if((nVertices > 0 && !mapped_vertices_) || (nIndices + nLineIndices > 0 && !mapped_indices_)) {
+            FinishUpload();
+            Release(range);
+            return false;
+        }
+        return true;
+    }
+
+    bool GeometryArena::FinishUpload()
+    {
+        if(persistent_) {
+            //coherent mapping: the writes are visible to every draw issued from now on
+            mapped_vertices_ = nullptr;
+            mapped_indices_ = nullptr;
+            return true;
+        }
+        bool b_intact = true;  //false if the storage was lost while mapped
+        if(mapped_vertices_) {
+            GL(glBindBuffer( GL_ARRAY_BUFFER, vb_id_ ));
+            b_intact = glUnmapBuffer( GL_ARRAY_BUFFER ) == GL_TRUE;
+            GL(glBindBuffer( GL_ARRAY_BUFFER, 0));
+        }
+        if(mapped_indices_) {
+            GL(glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ib_id_ ));
+            b_intact = glUnmapBuffer( GL_ELEMENT_ARRAY_BUFFER ) == GL_TRUE && b_intact;
+            GL(glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0));
+        }
+        mapped_vertices_ = nullptr;
+        mapped_indices_ = nullptr;
+        return b_intact;
+    }
+
+    void GeometryArena::Release(const ArenaRange& range)
+    {
+        vertices_.Free(range.baseVertex, range.numVertices);
+        indices_.Free(range.firstIndex, range.numIndices + range.numLineIndices);
+    }
+
+    void GeometryArena::WaitForDraws()
+    {
+        if(fence_) {
+            glClientWaitSync(fence_, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(fence_);
+            fence_ = 0;
+        }
+    }
+
+    void GeometryArena::FenceDraws()
+    {
+        if(persistent_) {
+            if(fence_) {
+                glDeleteSync(fence_);
+            }
+            fence_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+
+    void GeometryArena::Destroy()
+    {
+        if(fence_) {
+            glDeleteSync(fence_);
+            fence_ = 0;
+        }
+        //deleting a buffer also unmaps it
+        mapped_vertices_ = nullptr;
+        mapped_indices_ = nullptr;
+        persistent_vertices_ = nullptr;
+        persistent_indices_ = nullptr;
+        persistent_ = false;
+        GL(glDeleteVertexArrays( 1, &vao_id_ ));
+        GL(glDeleteBuffers( 1, &ib_id_ ));
+        GL(glDeleteBuffers( 1, &vb_id_ ));
+
+        vb_id_ = 0;
+        ib_id_ = 0;
+        vao_id_ = 0;
+        vertex_size_ = 0;
+        attribs_.clear();
+        vertices_.Reset(0);
+        indices_.Reset(0);
+    }
+
+    void GeometryArena::SubmitRanges(GLenum mode, const GLsizei* counts, const void* const* offsets,
+                                     const GLint* baseVertices, int nRanges)
+    {
+        if(nRanges == 0) {
+            return;
+        }
+        if(mode == GL_LINES) {
+            GL( glLineWidth(1) );
+        }
+        GL( glBindVertexArray( vao_id_ ) );
+        GL( glMultiDrawElementsBaseVertex(mode, counts, GL_UNSIGNED_INT, offsets, nRanges, baseVertices) );
+        GL( glBindVertexArray( 0 ) );
+        FenceDraws();
+    }
 }
\ No newline at end of file
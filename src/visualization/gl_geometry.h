@@ -3,6 +3,9 @@
 #include <GL/glew.h>
 #include <GL/gl.h>
 #include "gl_utils.h"
+#include "utils/range_allocator.h"
+#include <cstddef>
+#include <vector>
 
 namespace GLRendering {
 
@@ -46,4 +49,74 @@ namespace GLRendering {
         int             index_count_;
     };
 
+    //Where one mesh lives in a `GeometryArena`: its vertices from `baseVertex`, its triangle
+    //indices from `firstIndex` and its line indices right after them, relative to `baseVertex`.
+    struct ArenaRange {
+        int     baseVertex = 0;
+        int     numVertices = 0;
+        size_t  firstIndex = 0;
+        int     numIndices = 0;
+        int     numLineIndices = 0;
+    };
+
+    //One vertex buffer, one index buffer and one vertex array for every mesh of a vertex layout,
+    //e.g. all levels of a subdivision: each mesh is a sub-range, placed first fit in the free space,
+    //and ranges of several meshes are drawn by one `glMultiDrawElementsBaseVertex`. A buffer
+    //without room doubles at least, its contents are copied on the GPU.
+    //With `glBufferStorage` both buffers are persistently mapped for their whole life and an upload
+    //writes straight into the mapping, after waiting for the fence of the last draw or copy (a
+    //released range may still be read by a frame in flight); without it each upload maps only its range.
+    class GeometryArena {
+        public:
+        GeometryArena();
+
+        //`vertexSize`: bytes per vertex, the stride of every attribute
+        void Initialize(const ProgramAttribute* pAttribs, int nAttribs, int vertexSize);
+        bool IsInitialized() const { return vao_id_ != 0; }
+
+        //Reserve a range and return where its vertices and indices are written (line indices follow
+        //the triangle indices), from any thread, e.g. the workers of a pool, all joined before
+        //`FinishUpload`; the range is drawable from then on and until `Release`.
+        bool BeginUpload(int nVertices, int nIndices, int nLineIndices, ArenaRange& range);
+        void* MappedVertices() { return mapped_vertices_; }
+        unsigned int* MappedIndices() { return mapped_indices_; }
+        bool FinishUpload();
+        void Release(const ArenaRange& range);
+
+        void Destroy();
+        //`nRanges` runs of the index buffer, `offsets` in bytes from its start, each with its base vertex
+        void SubmitRanges(GLenum mode, const GLsizei* counts, const void* const* offsets,
+                          const GLint* baseVertices, int nRanges);
+
+        unsigned int GetVaoId() { return vao_id_; }
+        int GetVertexSize() { return vertex_size_; }
+        size_t GetBufferBytes() { return vertices_.Capacity() * vertex_size_ + indices_.Capacity() * sizeof(unsigned int); }
+        size_t GetRangeBytes(const ArenaRange& range) {
+            return range.numVertices * vertex_size_ + (range.numIndices + range.numLineIndices) * sizeof(unsigned int);
+        }
+
+    private:
+        unsigned int    vb_id_;
+        unsigned int    ib_id_;
+        unsigned int    vao_id_;
+        int             vertex_size_;
+        std::vector<ProgramAttribute> attribs_;
+        CommonUtils::RangeAllocator vertices_;  //in vertices
+        CommonUtils::RangeAllocator indices_;  //in indices
+        void*           mapped_vertices_;  //of the upload in progress
+        unsigned int*   mapped_indices_;
+        bool            persistent_;
+        void*           persistent_vertices_;  //whole buffers, persistent mapping only
+        void*           persistent_indices_;
+        GLsync          fence_;  //after the last draw or growth copy, persistent mapping only
+
+        //room for `count` elements in `bufferId`, grown if needed (`persistentData` follows the new
+        //buffer); false if it cannot be created
+        bool Allocate(GLenum target, unsigned int& bufferId, void*& persistentData, CommonUtils::RangeAllocator& allocator,
+                      size_t elementSize, size_t count, size_t& offset);
+        void BindVertexArray();
+        void WaitForDraws();
+        void FenceDraws();
+    };
+
 }
\ No newline at end of file
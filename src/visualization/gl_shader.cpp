@@ -8,7 +8,7 @@
 
 #include "gl_shader.h"
 #include "gl_utils.h"
-
+#include <cstring>
 
 #include <unistd.h>     // Need gettid()
 #include <sys/syscall.h>
@@ -47,7 +47,7 @@ Shader::Shader()
     , mFsId(0)
 {
     mRefCount = 0;
-    mUniformMap.Init(32);
+    mUniformMap.Reserve(32);
 }
 
 bool Shader::Initialize(int numVertStrings, const char** pVertSrc, int numFragStrings, const char** pFragSrc, const char* pVertDbgName, const char* pFragDbgName)
@@ -273,11 +273,8 @@ void Shader::Unbind()
     GL(glUseProgram(0));
 
     // Unbind all samplers
-    UniformMap::Iterator uniformIter = mUniformMap.GetIterator();
-    while (!uniformIter.End())
+    mUniformMap.ForEach([](const std::string&, const ShaderUniform& oneEntry)
     {
-        ShaderUniform oneEntry = uniformIter.Current();
-
         if (IsSamplerType(oneEntry.type))
         {
             // LOG("Uniform Iterator Entry:");
@@ -287,17 +284,15 @@ void Shader::Unbind()
             // LOG("    textureUnit = %d", oneEntry.textureUnit);
             GL(glBindSampler(oneEntry.textureUnit, 0));
         }
-
-        uniformIter.Next();
-    }
+    });
 }
 
 void Shader::SetUniformMat2(const char* name, glm::mat2& matrix)
 {
-    ShaderUniform  uniform;
-    if( mUniformMap.Find( name, &uniform))
+    const ShaderUniform* uniform = mUniformMap.Find(name);
+    if (uniform)
     {
-        SetUniformMat2(uniform.location, matrix);
+        SetUniformMat2(uniform->location, matrix);
     }
 }
 
@@ -308,10 +303,10 @@ void Shader::SetUniformMat2(int location, glm::mat2& matrix)
 
 void Shader::SetUniformMat2fv(const char* name, unsigned int count, float *pData)
 {
-    ShaderUniform  uniform;
-    if (mUniformMap.Find(name, &uniform))
+    const ShaderUniform* uniform = mUniformMap.Find(name);
+    if (uniform)
     {
-        SetUniformMat2fv(uniform.location, count, pData);
+        SetUniformMat2fv(uniform->location, count, pData);
     }
     //else
     //{
@@ -326,10 +321,10 @@ void Shader::SetUniformMat2fv(int location, unsigned int count, float *pData)
 
 void Shader::SetUniformMat3(const char* name, glm::mat3& matrix)
 {
-    ShaderUniform  uniform;
-    if (mUniformMap.Find(name, &uniform))
+    const ShaderUniform* uniform = mUniformMap.Find(name);
+    if (uniform)
     {
-        SetUniformMat3(uniform.location, matrix);
+        SetUniformMat3(uniform->location, matrix);
     }
 }
 
@@ -340,10 +335,10 @@ void Shader::SetUniformMat3(int location, glm::mat3& matrix)
 
 void Shader::SetUniformMat4(const char* name, glm::mat4& matrix)
 {
-    ShaderUniform  uniform;
-    if( mUniformMap.Find( name, &uniform ) )
+    const ShaderUniform* uniform = mUniformMap.Find(name);
+    if (uniform)
     {
-        SetUniformMat4(uniform.location, matrix);
+        SetUniformMat4(uniform->location, matrix);
     }
     else
     {
@@ -358,10 +353,10 @@ void Shader::SetUniformMat4(int location, glm::mat4& matrix)
 
 void Shader::SetUniformMat4fv(const char* name, unsigned int count, float *pData)
 {
-    ShaderUniform  uniform;
-    if (mUniformMap.Find(name, &uniform))
+    const ShaderUniform* uniform = mUniformMap.Find(name);
+    if (uniform)
     {
-        SetUniformMat4fv(uniform.location, count, pData);
+        SetUniformMat4fv(uniform->location, count, pData);
     }
     //else
     //{
@@ -376,10 +371,10 @@ void Shader::SetUniformMat4fv(int location, unsigned int count, float *pData)
 
 void Shader::SetUniformVec4(const char* name, glm::vec4& vector)
 {
-    ShaderUniform uniform;
-    if(mUniformMap.Find( name, &uniform))
+    const ShaderUniform* uniform = mUniformMap.Find(name);
+    if (uniform)
     {
-        SetUniformVec4(uniform.location, vector);
+        SetUniformVec4(uniform->location, vector);
     }
     //else
     //{
@@ -394,10 +389,10 @@ void Shader::SetUniformVec4(int location, glm::vec4& vector)
 
 void Shader::SetUniformVec3(const char* name, glm::vec3& vector)
 {
-    ShaderUniform uniform;
-    if (mUniformMap.Find(name, &uniform))
+    const ShaderUniform* uniform = mUniformMap.Find(name);
+    if (uniform)
     {
-        SetUniformVec3(uniform.location, vector);
+        SetUniformVec3(uniform->location, vector);
     }
 }
 
@@ -408,10 +403,10 @@ void Shader::SetUniformVec3(int location, glm::vec3& vector)
 
 void Shader::SetUniformVec2(const char* name, glm::vec2& vector)
 {
-    ShaderUniform uniform;
-    if (mUniformMap.Find(name, &uniform))
+    const ShaderUniform* uniform = mUniformMap.Find(name);
+    if (uniform)
     {
-        SetUniformVec2(uniform.location, vector);
+        SetUniformVec2(uniform->location, vector);
     }
 }
 
@@ -422,10 +417,10 @@ void Shader::SetUniformVec2(int location, glm::vec2& vector)
 
 void Shader::SetUniform1ui(const char* name, unsigned int value)
 {
-    ShaderUniform uniform;
-    if (mUniformMap.Find(name, &uniform))
+    const ShaderUniform* uniform = mUniformMap.Find(name);
+    if (uniform)
     {
-        SetUniform1ui(uniform.location, value);
+        SetUniform1ui(uniform->location, value);
     }    
 }
 
@@ -434,31 +429,109 @@ void Shader::SetUniform1ui(int location, unsigned int value)
     GL(glUniform1ui(location, value));
 }
 
+int Shader::FindUniformLocation(const char* name)
+{
+    const ShaderUniform* uniform = mUniformMap.Find(name);
+    if (uniform)
+    {
+        return (int)uniform->location;
+    }
+    LOG("Failed to find uniform %s on shader %d\n", name, mShaderId);
+    return -1;
+}
+
+void Shader::SetUniform(UniformHandle<glm::mat4> handle, const glm::mat4& matrix)
+{
+    GL(glUniformMatrix4fv(handle.Location(), 1, GL_FALSE, glm::value_ptr(matrix)));
+}
+
+void Shader::SetUniform(UniformHandle<glm::vec4> handle, const glm::vec4& vector)
+{
+    GL(glUniform4fv(handle.Location(), 1, glm::value_ptr(vector)));
+}
+
+void Shader::SetUniform(UniformHandle<glm::vec3> handle, const glm::vec3& vector)
+{
+    GL(glUniform3fv(handle.Location(), 1, glm::value_ptr(vector)));
+}
+
+void Shader::SetUniform(UniformHandle<unsigned int> handle, unsigned int value)
+{
+    GL(glUniform1ui(handle.Location(), value));
+}
+
+bool Shader::BindUniformBlock(const char* blockName, unsigned int bindingPoint)
+{
+    unsigned int blockIndex = GL(glGetUniformBlockIndex(mShaderId, blockName));
+    if (blockIndex == GL_INVALID_INDEX)
+    {
+        LOG("Failed to find uniform block %s on shader %d\n", blockName, mShaderId);
+        return false;
+    }
+    GL(glUniformBlockBinding(mShaderId, blockIndex, bindingPoint));
+    return true;
+}
+
+UniformBuffer::UniformBuffer()
+    : mBufferId(0)
+    , mBindingPoint(0)
+    , mSize(0)
+{
+}
+
+void UniformBuffer::Initialize(unsigned int bindingPoint, unsigned int size)
+{
+    mBindingPoint = bindingPoint;
+    mSize = size;
+    GL(glGenBuffers(1, &mBufferId));
+    GL(glBindBuffer(GL_UNIFORM_BUFFER, mBufferId));
+    GL(glBufferData(GL_UNIFORM_BUFFER, mSize, NULL, GL_STREAM_DRAW));
+    GL(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+    GL(glBindBufferBase(GL_UNIFORM_BUFFER, mBindingPoint, mBufferId));
+}
+
+void UniformBuffer::Destroy()
+{
+    if (mBufferId != 0)
+    {
+        GL(glDeleteBuffers(1, &mBufferId));
+    }
+    mBufferId = 0;
+    mSize = 0;
+}
+
+void UniformBuffer::Update(const void* pData)
+{
+    GL(glBindBuffer(GL_UNIFORM_BUFFER, mBufferId));
+    GL(glBufferData(GL_UNIFORM_BUFFER, mSize, pData, GL_STREAM_DRAW));
+    GL(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+}
+
 void Shader::SetUniformSampler(const char* name, unsigned int samplerId, unsigned int samplerType, GLuint samplerObjId)
 {
     bool fLogTextureInfo = false;
 
-    ShaderUniform uniform;
-    if(mUniformMap.Find( name, &uniform))
+    const ShaderUniform* uniform = mUniformMap.Find(name);
+    if (uniform)
     {
         if (fLogTextureInfo)
         {
             switch (samplerType)
             {
             case GL_TEXTURE_2D:
-                LOG("    %s: Texture Unit = %d; Sampler = %d; Type = GL_TEXTURE_2D", name, uniform.textureUnit, samplerId);
+                LOG("    %s: Texture Unit = %d; Sampler = %d; Type = GL_TEXTURE_2D", name, uniform->textureUnit, samplerId);
                 break;
 
             case GL_TEXTURE_CUBE_MAP:
-                LOG("    %s: Texture Unit = %d; Sampler = %d; Type = GL_TEXTURE_CUBE_MAP", name, uniform.textureUnit, samplerId);
+                LOG("    %s: Texture Unit = %d; Sampler = %d; Type = GL_TEXTURE_CUBE_MAP", name, uniform->textureUnit, samplerId);
                 break;
 
             case GL_TEXTURE_EXTERNAL_OES:
-                LOG("    %s: Texture Unit = %d; Sampler = %d; Type = GL_TEXTURE_EXTERNAL_OES", name, uniform.textureUnit, samplerId);
+                LOG("    %s: Texture Unit = %d; Sampler = %d; Type = GL_TEXTURE_EXTERNAL_OES", name, uniform->textureUnit, samplerId);
                 break;
 
             default:
-                LOG("    %s: Texture Unit = %d; Sampler = %d; Type = %d", name, uniform.textureUnit, samplerId, samplerType);
+                LOG("    %s: Texture Unit = %d; Sampler = %d; Type = %d", name, uniform->textureUnit, samplerId, samplerType);
                 break;
             }
         }
@@ -466,11 +539,11 @@ void Shader::SetUniformSampler(const char* name, unsigned int samplerId, unsigne
         // It turns out the driver does not handle samplers on image textures :(
         if (samplerObjId != 0 && samplerType != GL_TEXTURE_EXTERNAL_OES)
         {
-            // LOG("Binding sampler %d to unit %d", samplerObjId, uniform.textureUnit);
-            GL(glBindSampler(uniform.textureUnit, samplerObjId));
+            // LOG("Binding sampler %d to unit %d", samplerObjId, uniform->textureUnit);
+            GL(glBindSampler(uniform->textureUnit, samplerObjId));
         }
 
-        GL(glActiveTexture(GL_TEXTURE0 + uniform.textureUnit));
+        GL(glActiveTexture(GL_TEXTURE0 + uniform->textureUnit));
         GL(glBindTexture(samplerType, samplerId));
     }
     // else
@@ -12,7 +12,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-#include "utils/hash_table.h"
+#include "utils/flat_hash_map.h"
+#include <string>
 
 #define MAX_UNIFORM_NAME_LENGTH 64
 
@@ -27,8 +28,8 @@
 
 namespace GLRendering
 {
-    using CommonUtils::HashTable;
-    using CommonUtils::DjB2Hash;
+    using CommonUtils::FlatHashMap;
+    using CommonUtils::StringHash;
 
     enum AttributeLocation
     {
@@ -53,6 +54,38 @@ namespace GLRendering
         unsigned int textureUnit;
     };
 
+    // A uniform location resolved once by Shader::GetUniform, typed by the value it takes, so
+    // setting it per draw is a plain glUniform* call. -1 (not active) is ignored by GL.
+    template <class T>
+    class UniformHandle
+    {
+    public:
+        UniformHandle() : mLocation(-1) {}
+        explicit UniformHandle(int location) : mLocation(location) {}
+        int Location() const { return mLocation; }
+
+    private:
+        int mLocation;
+    };
+
+    // A uniform buffer object on one binding point, shared by every program whose uniform block
+    // is bound to the same point (Shader::BindUniformBlock)
+    class UniformBuffer
+    {
+    public:
+        UniformBuffer();
+
+        void Initialize(unsigned int bindingPoint, unsigned int size);
+        void Destroy();
+        // whole buffer, the previous storage is orphaned so a frame in flight is not waited for
+        void Update(const void* pData);
+
+    private:
+        unsigned int mBufferId;
+        unsigned int mBindingPoint;
+        unsigned int mSize;
+    };
+
     class Shader
     {
     public:
@@ -83,13 +116,22 @@ namespace GLRendering
         void SetUniform1ui(int location, unsigned int value);
         void SetUniformSampler(const char* name, unsigned int samplerId, unsigned int samplerType, GLuint samplerObjId);
 
+        // Name lookups happen here only, resolve the handles once after Initialize
+        template <class T>
+        UniformHandle<T> GetUniform(const char* name) { return UniformHandle<T>(FindUniformLocation(name)); }
+        void SetUniform(UniformHandle<glm::mat4> handle, const glm::mat4& matrix);
+        void SetUniform(UniformHandle<glm::vec4> handle, const glm::vec4& vector);
+        void SetUniform(UniformHandle<glm::vec3> handle, const glm::vec3& vector);
+        void SetUniform(UniformHandle<unsigned int> handle, unsigned int value);
+        bool BindUniformBlock(const char* blockName, unsigned int bindingPoint);
+
         unsigned int GetShaderId() { return mShaderId;  }
 
     private:
         static unsigned int gCurrentBoundShader;
 
-        typedef HashTable<unsigned int, ShaderUniform, DjB2Hash> UniformMap;
-        typedef HashTable<unsigned int, unsigned int, DjB2Hash> SamplerMap;
+        // looked up by `const char*` without building a std::string
+        typedef FlatHashMap<std::string, ShaderUniform, StringHash, std::equal_to<>> UniformMap;
 
         unsigned int    mRefCount;
 
@@ -97,5 +139,7 @@ namespace GLRendering
         unsigned int    mVsId;
         unsigned int    mFsId;
         UniformMap      mUniformMap;
+
+        int FindUniformLocation(const char* name);
     };
 }
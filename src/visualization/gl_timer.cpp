@@ -0,0 +1,70 @@
+#include "gl_timer.h"
+#include "gl_utils.h"
+
+namespace GLRendering{
+    GpuTimer::GpuTimer()
+        : current_(0)
+        , b_running_(false)
+        , last_ms_(-1.0)
+    {
+        for(int i = 0 ; i < kNumQueries ; i++) {
+            query_ids_[i] = 0;
+            b_pending_[i] = false;
+        }
+    }
+
+    void GpuTimer::Initialize()
+    {
+        GL(glGenQueries(kNumQueries, query_ids_));
+    }
+
+    void GpuTimer::Destroy()
+    {
+        GL(glDeleteQueries(kNumQueries, query_ids_));
+        for(int i = 0 ; i < kNumQueries ; i++) {
+            query_ids_[i] = 0;
+            b_pending_[i] = false;
+        }
+        b_running_ = false;
+    }
+
+    void GpuTimer::Collect(int slot)
+    {
+        if(!b_pending_[slot]) {
+            return;
+        }
+        GLint available = 0;
+        GL(glGetQueryObjectiv(query_ids_[slot], GL_QUERY_RESULT_AVAILABLE, &available));
+        if(available) {
+            GLuint64 nanoseconds = 0;
+            GL(glGetQueryObjectui64v(query_ids_[slot], GL_QUERY_RESULT, &nanoseconds));
+            last_ms_ = nanoseconds * 1e-6;
+            b_pending_[slot] = false;
+        }
+    }
+
+    void GpuTimer::Begin()
+    {
+        if(query_ids_[0] == 0) {
+            return;
+        }
+        //oldest first so the newest finished result is kept
+        Collect(current_);
+        Collect((current_ + 1) % kNumQueries);
+        b_running_ = !b_pending_[current_];
+        if(b_running_) {
+            GL(glBeginQuery(GL_TIME_ELAPSED, query_ids_[current_]));
+        }
+    }
+
+    void GpuTimer::End()
+    {
+        if(!b_running_) {
+            return;
+        }
+        GL(glEndQuery(GL_TIME_ELAPSED));
+        b_pending_[current_] = true;
+        b_running_ = false;
+        current_ = (current_ + 1) % kNumQueries;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <GL/glew.h>
+
+namespace GLRendering {
+
+    //GPU time of the commands between `Begin()` and `End()` from `GL_TIME_ELAPSED` queries.
+    //Two queries alternate between frames and a result is only read once it is available,
+    //so the timer never waits for the GPU; a frame whose query is still in flight is skipped.
+    class GpuTimer {
+        public:
+        GpuTimer();
+
+        void Initialize();
+        void Destroy();
+        void Begin();
+        void End();
+
+        //of the latest finished query, usually one or two frames old, -1 before the first one
+        double LastMilliseconds() const { return last_ms_; }
+
+    private:
+        static const int kNumQueries = 2;
+        unsigned int    query_ids_[kNumQueries];
+        bool            b_pending_[kNumQueries];
+        int             current_;
+        bool            b_running_;
+        double          last_ms_;
+
+        void Collect(int slot);
+    };
+
+}
@@ -18,11 +18,90 @@
 #include "subdivision/loop_solver.h"
 #include "utils/geometry_utils.h"
 #include "subdivision/doo_solver.h"
+#include "subdivision/smesh_io.h"
 #include <numeric>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
 
 
 namespace GLRendering {
 
+	namespace {
+		//cycled with P, the first one is the default
+		const SubDivision::PackedVertexFormat kVertexFormats[] = {
+			{SubDivision::kPositionUnorm16, SubDivision::kNormalOctahedral},
+			{SubDivision::kPositionHalf, SubDivision::kNormalInt2101010},
+			{SubDivision::kPositionFloat, SubDivision::kNormalFloat},
+		};
+
+		//in chunks over the pool, e.g. into a mapped index buffer
+		void CopyIndices(CommonUtils::ThreadPool* pool, const std::vector<uint32_t>& indices, unsigned int* out) {
+			pool->ParallelFor(0, indices.size(), size_t(1) << 16, [&](size_t begin, size_t end) {
+				std::memcpy(out + begin, indices.data() + begin, (end - begin) * sizeof(uint32_t));
+			});
+		}
+
+		//radius of the sphere around the origin holding the first 3 floats of every record
+		float BoundingRadius(const float* data, size_t stride, size_t num_records) {
+			float squared_radius = 0.0f;
+			for(size_t i = 0 ; i < num_records ; i++) {
+				const float* p = data + stride * i;
+				squared_radius = std::max(squared_radius, p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+			}
+			return std::sqrt(squared_radius);
+		}
+
+		//attributes of a record `format.Stride()` bytes long
+		void PackedAttributes(const SubDivision::PackedVertexFormat& format, ProgramAttribute attribs[2]) {
+			const int vertexSize = format.Stride();
+			attribs[0].index = kPosition;
+			attribs[0].size = 3;
+			attribs[0].stride = vertexSize;
+			attribs[0].offset = 0;
+			if(format.position == SubDivision::kPositionFloat) {
+				attribs[0].type = GL_FLOAT;
+				attribs[0].normalized = false;
+			} else if(format.position == SubDivision::kPositionHalf) {
+				attribs[0].type = GL_HALF_FLOAT;
+				attribs[0].normalized = false;
+			} else {
+				attribs[0].type = GL_UNSIGNED_SHORT;  //[0, 1], scaled back by `positionScale`
+				attribs[0].normalized = true;
+			}
+
+			attribs[1].index = kNormal;
+			attribs[1].stride = vertexSize;
+			attribs[1].offset = format.PositionBytes();
+			if(format.normal == SubDivision::kNormalFloat) {
+				attribs[1].size = 3;
+				attribs[1].type = GL_FLOAT;
+				attribs[1].normalized = false;
+			} else if(format.normal == SubDivision::kNormalInt2101010) {
+				attribs[1].size = 4;  //packed types always have 4 components, w is unused
+				attribs[1].type = GL_INT_2_10_10_10_REV;
+				attribs[1].normalized = true;
+			} else {
+				attribs[1].size = 2;  //decoded by the vertex shader
+				attribs[1].type = GL_SHORT;
+				attribs[1].normalized = true;
+			}
+		}
+
+		//planes of the clip volume of `clipFromModel` in model space (Gribb/Hartmann),
+		//normalised so `dot(xyz, p) + w` is the signed distance of p, positive inside
+		void FrustumPlanes(const glm::mat4& clipFromModel, glm::vec4 planes[6]) {
+			const glm::mat4 rows = glm::transpose(clipFromModel);
+			for(int i = 0 ; i < 3 ; i++) {
+				planes[2 * i] = rows[3] + rows[i];
+				planes[2 * i + 1] = rows[3] - rows[i];
+			}
+			for(int i = 0 ; i < 6 ; i++) {
+				planes[i] /= glm::length(glm::vec3(planes[i]));
+			}
+		}
+	}
+
 
 	Viewer::Viewer() {
 		b_setup_ = false;
@@ -47,6 +126,15 @@ namespace GLRendering {
 		light_pos_ = glm::vec3(screen_width / 2.0, screen_height / 2.0, 1000.0f);
 		b_initialization_window_ = true;
 		config_ = config;
+		b_continuous_ = config_.continuous_rendering;
+		if(!config_.frame_log_path.empty()) {
+			frame_log_.open(config_.frame_log_path);
+			if(frame_log_.is_open()) {
+				frame_log_<<"frame,cpu_ms,gpu_ms,triangles,vertices,buffer_bytes,level,subdivision_s,upload_ms\n";
+			} else {
+				std::cerr << "fail to open file " + config_.frame_log_path << std::endl;
+			}
+		}
 		if(InitializeContext()) {
 			b_setup_ = true;
 		}
@@ -56,7 +144,7 @@ namespace GLRendering {
 
 	void Viewer::ResetContollingVariables() {
 		CallBackController::Instance().SetUp(0.0f, 0.0f, 5.0f);  //set up camera
-		view_level_ = 0;
+		SelectLevel(0);
 		b_show_wireframe_ = false;
 	}
 
@@ -87,6 +175,8 @@ namespace GLRendering {
 
 		glfwSetFramebufferSizeCallback(window_, CallBackController::FramebufferSizeCallback);
 		glfwSetCursorPosCallback(window_, CallBackController::MouseMotionCallback);
+		glfwSetKeyCallback(window_, CallBackController::KeyCallback);
+		glfwSetWindowRefreshCallback(window_, CallBackController::WindowRefreshCallback);
 		//glfwSetScrollCallback(window_, scroll_callback);
 		//glfwSetMouseButtonCallback(window_, DefaultMotionFunc);
 
@@ -112,7 +202,19 @@ namespace GLRendering {
     	char *tmp_char = nullptr;
     	glutInit(&tmp_val, &tmp_char);
 
+		//names are looked up here once, draws only set the resolved handles
+		model_uniforms_.modelMatrix = shader_.GetUniform<glm::mat4>("modelMatrix");
+		model_uniforms_.modelColor = shader_.GetUniform<glm::vec3>("modelColor");
+		model_uniforms_.octahedralNormal = shader_.GetUniform<unsigned int>("octahedralNormal");
+		if(!shader_.BindUniformBlock("FrameUniforms", kFrameUniformsBinding) ||
+		   !shader_.BindUniformBlock("LevelUniforms", kLevelUniformsBinding)) {
+			return false;
+		}
+		frame_uniforms_.Initialize(kFrameUniformsBinding, sizeof(FrameUniforms));
+		level_uniforms_.Initialize(kLevelUniformsBinding, sizeof(LevelUniforms));
+
 		glEnable(GL_DEPTH_TEST);
+		gpu_timer_.Initialize();
 		return true;
 
 	}
@@ -137,8 +239,27 @@ namespace GLRendering {
 			//// per-frame time logic
 			//// --------------------
 			float currentframe = glfwGetTime();
+			if(b_continuous_) {
+				glfwPollEvents();
+			} else if(!b_redraw_) {
+				if(b_show_stats_) {
+					glfwWaitEventsTimeout(kOverlayRefreshSeconds);
+					b_redraw_ = true;  //the GPU time of the last frame is only known now
+				} else {
+					glfwWaitEvents();
+				}
+			}
+			CommonUtils::Timer frame_timer;
+			frame_stats_.num_triangles = frame_stats_.num_vertices = frame_stats_.buffer_bytes = 0;
 
 			KeyBoardCallBack();
+			if(ReceiveLevels()) {
+				b_redraw_ = true;
+			}
+			if(!b_redraw_ && !b_continuous_) {
+				continue;  //woken by an event that changes nothing, e.g. the cursor moving without a button
+			}
+			b_redraw_ = false;
 
 			
 			// ------
@@ -146,15 +267,25 @@ namespace GLRendering {
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 			//	========================================================
+			gpu_timer_.Begin();
 			Display();
+			gpu_timer_.End();
 			//  ========================================================
+			frame_stats_.cpu_ms = 1000.0 * frame_timer.ElapsedSeconds();
+			frame_stats_.gpu_ms = gpu_timer_.LastMilliseconds();
+			LogFrame();
 
 
-			// glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+			// glfw: swap buffers, IO events (keys pressed/released, mouse moved etc.) are
+			// handled at the top of the loop
 			// -------------------------------------------------------------------------------
 			glfwSwapBuffers(window_);
-			glfwPollEvents();
 		}
+		StopSubdivision();
+		ReleaseModels();
+		gpu_timer_.Destroy();
+		frame_uniforms_.Destroy();
+		level_uniforms_.Destroy();
 		// glfw: terminate, clearing all previously allocated GLFW resources.
 		// ------------------------------------------------------------------
 		glfwTerminate();
@@ -199,6 +330,7 @@ namespace GLRendering {
 		PutText(-0.9f, 0.78f, "Z: Loop subdivision");
 		PutText(-0.9f, 0.71f, "X: Catmull-Clark subdivision");
 		PutText(-0.9f, 0.64f, "C: Doo-Sabin subdivision");
+		DisplayProgress();  //a failed load is reported here
 		if(used_method >= 0) {
 			if(used_method == 0) {
 				method_name = "Loop subdivision";
@@ -208,13 +340,10 @@ namespace GLRendering {
 				method_name = "Doo-Sabin subdivision";
 
 			}
-			if(Subdivision()) {
-				used_method = -1;
-				ResetContollingVariables();
-				b_initialization_window_ = false;
-			} else {
-				
-			}
+			StartSubdivision(used_method);
+			used_method = -1;
+			ResetContollingVariables();
+			b_initialization_window_ = false;
 			
 		}
 			
@@ -227,69 +356,41 @@ namespace GLRendering {
 			return;
 		}
 		
+		DisplayProgress();
 		if(view_level_ == -1) {
 			return;
 		}
     	
-		if(b_show_wireframe_) {
-			RenderFixed(models_.at(view_level_));
-		} else {
-			Render(models_.at(view_level_));
-		}
+		const std::vector<int> levels = DrawnLevels();
+		Render(levels);
 		PutText(-0.9f, 0.85f, "Key:");
-    	PutText(-0.9f, 0.78f, "W: next level of subdivision");
+    	PutText(-0.9f, 0.78f, "W: next level of subdivision (computed on demand)");
     	PutText(-0.9f, 0.71f, "D: previous level of subdivision");
     	PutText(-0.9f, 0.64f, "F: switch between wireframe and mesh");
-		PutText(-0.9f, 0.57f, method_name);
-
-	}
-
-	void Viewer::RenderFixed(const ModelAttrib& modelItem) {
-		const auto& camera = CallBackController::Instance().GetCamera();
-
-		glMatrixMode(GL_PROJECTION); //project matrix
-		glLoadIdentity();
-		//gluPerspective(glm::radians(camera.zoom_), (float)screen_width_ / (float)screen_height_, 0.1f, 10000.0f);
-		glm::mat4 projection = glm::perspective(glm::radians(camera.zoom_), (float)screen_width_ / (float)screen_height_, 0.1f, 10000.0f);
-		glMultMatrixf(glm::value_ptr(projection));
-
-		if(verbose) {
-			std::cout<<"/// Rendering Fixed() \n";
+		PutText(-0.9f, 0.57f, "P: switch vertex format");
+		PutText(-0.9f, 0.50f, "K: switch cluster culling");
+		PutText(-0.9f, 0.43f, "V: compare with the previous levels side by side");
+		PutText(-0.9f, 0.36f, "H: switch performance overlay");
+		PutText(-0.9f, 0.29f, b_continuous_ ? "R: redraw on demand (now: every frame)" : "R: redraw every frame (now: on demand)");
+		PutText(-0.9f, 0.22f, method_name);
+		PutText(-0.9f, 0.15f, vertex_format_.Name());
+		size_t num_clusters = 0;
+		for(const int level : levels) {
+			num_clusters += models_.at(level).meshlets.size();
 		}
-		
-		glMatrixMode(GL_MODELVIEW); //view matrix
-		glPushMatrix();
-		glLoadIdentity();
-		const glm::mat4 view_matrix = camera.ViewMatrix();
-		glMultMatrixf(glm::value_ptr(view_matrix));
-
-		if(verbose) {
-			Output("projection", projection);
-			Output("view_matrix", view_matrix);
+		if(b_cull_clusters_ && !b_show_wireframe_ && num_clusters > 0) {
+			PutText(-0.9f, 0.08f, "clusters drawn: " + std::to_string(num_drawn_clusters_) + " / " + std::to_string(num_clusters));
+		}
+		if(b_show_stats_) {
+			DisplayStats();
 		}
-		glBegin(GL_LINES);
-		
-		//for(auto& modelItem: models_) {
-			if(verbose) {
-				Output("color", modelItem.modelColor);
-			}
-			glColor3f(modelItem.modelColor.x, modelItem.modelColor.y, modelItem.modelColor.z); 
-			const std::vector<float>& data = modelItem.edges_data;
-			// data must satisfy (data.size() / 3) %2 == 0
-			// for (data[j*3] . .) and (data[(j+1)*3] . .) producing  a line
-			for(int j = 0 ; j < data.size() ; j+=3) {
-				if(verbose) {
-					std::cout<<"vertex ("<<j / 3<<")"<<data.at(j)<<", "<<data.at(j+1)<<", "<<data.at(j+2)<<"\n";
-				}
-				glVertex3f(data.at(j), data.at(j+1), data.at(j+2));
-			}
-		//}
-		glEnd();
-		glPopMatrix();
 
 	}
 
-	void Viewer::Render(ModelAttrib& modelItem){
+	void Viewer::Render(const std::vector<int>& levels){
+		if(levels.empty()) {
+			return;
+		}
 		
 		const auto& camera = CallBackController::Instance().GetCamera();
 		glm::mat4 projection = glm::perspective(glm::radians(camera.zoom_), (float)screen_width_ / (float)screen_height_, 0.1f, 100.0f);
@@ -311,27 +412,141 @@ namespace GLRendering {
 		//Output("view_matrix", view_matrix);
 
 
+		//once per frame, shared by every submission
+		FrameUniforms frame;
+		frame.projectionMatrix = projection;
+		frame.viewMatrix = view_matrix;
+		frame.eyePos = glm::vec4(eye_pos, 1.0f);
+		frame.lightPos = glm::vec4(light_pos_, 1.0f);
+		frame_uniforms_.Update(&frame);
+
 		shader_.Bind();
-		shader_.SetUniformMat4("projectionMatrix", projection);
-		shader_.SetUniformMat4("viewMatrix", view_matrix);
-		shader_.SetUniformVec3("eyePos", eye_pos);
-		shader_.SetUniformVec3("lightPos", light_pos_);
+		shader_.SetUniform(model_uniforms_.modelMatrix, model_matrix); //occasion 1
+		//shader_.SetUniform(model_uniforms_.modelMatrix, modelItem.modelMatrix); //occasion 2
+
+		//side by side in view space, each level scaled down around its origin to its share of the width
+		float radius = 0.0f;
+		for(const int level : levels) {
+			radius = std::max(radius, models_.at(level).radius);
+		}
+		const float scale = 1.0f / levels.size();
+		num_drawn_clusters_ = 0;
+		for(GeometryArena* arena : {&arena_, &pnc_arena_}) {
+			//every level of the arena in one multi-draw, the vertex shader picks its `DrawnLevel`
+			LevelUniforms uniforms;
+			uniforms.numLevels = 0;
+			const ModelAttrib* firstItem = nullptr;
+			draw_counts_.clear();
+			draw_offsets_.clear();
+			draw_base_vertices_.clear();
+			for(size_t i = 0 ; i < levels.size() ; i++) {
+				const ModelAttrib& modelItem = models_.at(levels[i]);
+				if(modelItem.arena != arena) {
+					continue;
+				}
+				const ArenaRange& range = modelItem.range;
+				const glm::vec3 translation((2.0f * i + 1.0f - levels.size()) * radius * scale, 0.0f, 0.0f);
+				DrawnLevel& drawn = uniforms.levels[uniforms.numLevels++];
+				drawn.placement = glm::vec4(translation, scale);
+				drawn.positionScale = glm::vec4(modelItem.positionScale, 0.0f);
+				drawn.positionOffset = glm::vec4(modelItem.positionOffset, 0.0f);
+				drawn.vertexRange = glm::ivec4(range.baseVertex, range.baseVertex + range.numVertices, 0, 0);
+
+				if(b_show_wireframe_) {
+					AppendDrawRange(range.numLineIndices, range.firstIndex + range.numIndices, range.baseVertex);  //same vertices, same cost as shading
+				} else if(b_cull_clusters_ && !modelItem.meshlets.empty()) {
+					const glm::mat4 viewFromModel = view_matrix * glm::translate(glm::mat4(1.0f), translation) *
+													model_matrix * glm::scale(glm::mat4(1.0f), glm::vec3(scale));
+					AppendVisibleClusters(modelItem, projection * viewFromModel, viewFromModel);
+				} else {
+					AppendDrawRange(range.numIndices, range.firstIndex, range.baseVertex);
+					frame_stats_.num_triangles += range.numIndices / 3;
+				}
+				frame_stats_.num_vertices += range.numVertices;
+				if(!firstItem) {
+					firstItem = &modelItem;
+				}
+			}
+			if(!firstItem) {
+				continue;
+			}
+			level_uniforms_.Update(&uniforms);
+			shader_.SetUniform(model_uniforms_.modelColor, firstItem->modelColor);
+			shader_.SetUniform(model_uniforms_.octahedralNormal, firstItem->octahedralNormal);  //one vertex format per arena
+			arena->SubmitRanges(b_show_wireframe_ ? GL_LINES : firstItem->renderingMode, draw_counts_.data(),
+								draw_offsets_.data(), draw_base_vertices_.data(), draw_counts_.size());
+			frame_stats_.buffer_bytes += arena->GetBufferBytes();
+		}
 
+		shader_.Unbind();
+	}
 
-		//{
-			//for(auto& modelItem: models_) {
-				shader_.SetUniformMat4("modelMatrix",model_matrix); //occasion 1
-				//shader_.SetUniformMat4("modelMatrix",modelItem.second.modelMatrix); //occasion 2
+	void Viewer::AppendDrawRange(GLsizei count, size_t first_index, GLint base_vertex) {
+		const void* offset = (const void*)(unsigned long long)(first_index * sizeof(unsigned int));
+		if(!draw_counts_.empty() && draw_base_vertices_.back() == base_vertex &&
+		   (const char*)draw_offsets_.back() + draw_counts_.back() * sizeof(unsigned int) == (const char*)offset) {
+			draw_counts_.back() += count;
+			return;
+		}
+		draw_counts_.push_back(count);
+		draw_offsets_.push_back(offset);
+		draw_base_vertices_.push_back(base_vertex);
+	}
 
-				shader_.SetUniformVec3("modelColor",modelItem.modelColor);
+	void Viewer::AppendVisibleClusters(const ModelAttrib& modelItem, const glm::mat4& clipFromModel, const glm::mat4& viewFromModel) {
+		glm::vec4 planes[6];
+		FrustumPlanes(clipFromModel, planes);
+		const glm::vec4 eye = glm::inverse(viewFromModel) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		const float eye_pos[3] = {eye.x, eye.y, eye.z};
+
+		for(const auto& meshlet : modelItem.meshlets) {
+			const glm::vec3 center(meshlet.center[0], meshlet.center[1], meshlet.center[2]);
+			bool b_visible = !meshlet.IsBackfacing(eye_pos);
+			for(int i = 0 ; i < 6 && b_visible ; i++) {
+				b_visible = glm::dot(glm::vec3(planes[i]), center) + planes[i].w >= -meshlet.radius;
+			}
+			if(!b_visible) {
+				continue;
+			}
+			num_drawn_clusters_++;
+			//neighbour survivors are contiguous in the index buffer, one range covers them
+			AppendDrawRange(meshlet.index_count, modelItem.range.firstIndex + meshlet.first_index, modelItem.range.baseVertex);
+			frame_stats_.num_triangles += meshlet.index_count / 3;
+		}
+	}
 
-				modelItem.model->Submit(modelItem.renderingMode);
-			//}
-		//}
-		
-		shader_.Unbind();
+	void Viewer::DisplayStats() {
+		std::ostringstream lines[4];
+		lines[0]<<std::fixed<<std::setprecision(2)<<"frame: "<<frame_stats_.cpu_ms<<" ms CPU, ";
+		if(frame_stats_.gpu_ms < 0.0) {
+			lines[0]<<"GPU time not available";
+		} else {
+			lines[0]<<std::fixed<<std::setprecision(2)<<frame_stats_.gpu_ms<<" ms GPU";
+		}
+		lines[1]<<"submitted: "<<frame_stats_.num_triangles<<" triangles, "<<frame_stats_.num_vertices<<" vertices";
+		lines[2]<<std::fixed<<std::setprecision(1)<<"GPU buffers: "<<frame_stats_.buffer_bytes / (1024.0 * 1024.0)<<" MB";
+		lines[3]<<"level "<<view_level_<<": ";
+		if(view_level_ < static_cast<int>(level_progress_.size()) && level_progress_[view_level_].state == LevelProgress::kReady) {
+			lines[3]<<std::fixed<<std::setprecision(2)<<"subdivided in "<<level_progress_[view_level_].seconds<<" s, ";
+		}
+		lines[3]<<std::fixed<<std::setprecision(1)<<"uploaded in "<<upload_ms_<<" ms";
+		for(int i = 0 ; i < 4 ; i++) {
+			PutText(0.2f, 0.85f - 0.07f * i, lines[i].str());
+		}
 	}
 
+	void Viewer::LogFrame() {
+		if(!frame_log_.is_open()) {
+			return;
+		}
+		double subdivision_seconds = 0.0;
+		if(view_level_ >= 0 && view_level_ < static_cast<int>(level_progress_.size())) {
+			subdivision_seconds = level_progress_[view_level_].seconds;
+		}
+		frame_log_<<num_frames_++<<","<<frame_stats_.cpu_ms<<","<<frame_stats_.gpu_ms<<","<<frame_stats_.num_triangles<<","
+				  <<frame_stats_.num_vertices<<","<<frame_stats_.buffer_bytes<<","<<view_level_<<","<<subdivision_seconds<<","
+				  <<upload_ms_<<"\n";
+	}
 
 	//reference code:
 	void Viewer::PutText(float x, float y, std::string str) {
@@ -358,8 +573,8 @@ namespace GLRendering {
 	}
 	
 
-	ModelAttrib* Viewer::CreateMeshPNC(const float* pData, const int stride, const int num_vertex, const glm::vec3& modelColor,
-										const glm::mat4& modelMatrix) {  
+	ModelAttrib* Viewer::CreateMeshPNC(const int level, const float* pData, const int stride, const int num_vertex,
+										const glm::vec3& modelColor, const glm::mat4& modelMatrix) {  
 		
 		if(verbose) {
 			std::cout<<"pData:\n";
@@ -375,46 +590,65 @@ namespace GLRendering {
 			}
 		}
 
-		const int num_indices = num_vertex;
-		unsigned int* indices = new unsigned int[num_indices];
-		for(int i = 0 ; i < num_indices ; i++) {
-			indices[i] = i;
+		//one record per triangle corner: the index buffer is the identity, the wireframe
+		//is the 3 edges of every triangle
+		std::vector<unsigned int> indices(num_vertex);
+		std::iota(indices.begin(), indices.end(), 0u);
+		std::vector<unsigned int> line_indices(2 * num_vertex);
+		for(int i = 0 ; i < num_vertex ; i++) {
+			line_indices[2 * i] = i;
+			line_indices[2 * i + 1] = (i % 3 == 2 ? i - 2 : i + 1);
 		}
+		return CreateMeshPNC(level, pData, stride, num_vertex, indices.data(), num_vertex,
+							 line_indices.data(), line_indices.size(), modelColor, modelMatrix);
+	}
 
-		const int idx = models_.size();
-		models_[idx].model = CreateGeometryPNC(pData, stride, num_vertex,indices, num_indices);
-		models_[idx].modelMatrix = modelMatrix;
-		models_[idx].modelColor = modelColor;
-		models_[idx].renderingMode = GL_TRIANGLES;
-
-
-		//preserve data for drawing wireframe
-		
-		models_[idx].edges_data.reserve(3 * num_vertex);
-		for(int i = 0 ; i < num_vertex ; i++) {
-			int edge_id1 = i * stride;
-			int edge_id2 = (i % 3 == 2 ? ((i - 2) * stride) : ((i + 1) * stride));
-			models_[idx].edges_data.emplace_back(pData[edge_id1]);
-			models_[idx].edges_data.emplace_back(pData[edge_id1 + 1]);
-			models_[idx].edges_data.emplace_back(pData[edge_id1 + 2]);
+	ModelAttrib* Viewer::CreateMeshPNC(const int level, const float* pData, const int stride, const int num_vertex,
+									const unsigned int* indices, const int num_indices,
+									const unsigned int* line_indices, const int num_line_indices,
+									const glm::vec3& modelColor, const glm::mat4& modelMatrix) {
 
-			models_[idx].edges_data.emplace_back(pData[edge_id2]);
-			models_[idx].edges_data.emplace_back(pData[edge_id2 + 1]);
-			models_[idx].edges_data.emplace_back(pData[edge_id2 + 2]);
+		const int vertexSize = stride * sizeof(float);
+		if(!pnc_arena_.IsInitialized()) {
+			ProgramAttribute attribs[2];
+			int nAttribs = 2;
+			attribs[0].index = kPosition;
+			attribs[0].size = 3;
+			attribs[0].type = GL_FLOAT;
+			attribs[0].normalized = false;
+			attribs[0].stride = vertexSize;
+			attribs[0].offset = 0;
+
+			attribs[1].index = kNormal;
+			attribs[1].size = 3;
+			attribs[1].type = GL_FLOAT;
+			attribs[1].normalized = false;
+			attribs[1].stride = vertexSize;
+			attribs[1].offset = 3 * sizeof(float);
+			//the colour floats stay in the records but the shader has no colour input
+			pnc_arena_.Initialize(&attribs[0], nAttribs, vertexSize);
+		} else if(pnc_arena_.GetVertexSize() != vertexSize) {
+			std::cerr << "records of " << stride << " floats do not fit the meshes already created" << std::endl;
+			return nullptr;
 		}
 
-		if(verbose) {
-			std::cout<<"Points:\n";
-			for(int i = 0 ; i < models_[idx].edges_data.size() ; i+=3) {
-				std::cout<<"("<< i / 3<<") ";
-				std::cout<<models_[idx].edges_data.at(i)<<" ";
-				std::cout<<models_[idx].edges_data.at(i + 1)<<" ";
-				std::cout<<models_[idx].edges_data.at(i + 2)<<" ";
-				std::cout<<"\n";
-			}
+		const int idx = level;
+		if(models_.count(idx)) {
+			ReleaseLevel(idx);
 		}
-
-		delete[] indices;
+		ArenaRange range;
+		if(!UploadGeometryPNC(pnc_arena_, pData, stride, num_vertex, indices, num_indices, line_indices, num_line_indices, range)) {
+			return nullptr;
+		}
+		models_[idx].arena = &pnc_arena_;
+		models_[idx].range = range;
+		models_[idx].modelMatrix = modelMatrix;
+		models_[idx].modelColor = modelColor;
+		models_[idx].renderingMode = GL_TRIANGLES;
+		models_[idx].positionScale = glm::vec3(1.0f);
+		models_[idx].positionOffset = glm::vec3(0.0f);
+		models_[idx].octahedralNormal = 0;
+		models_[idx].radius = BoundingRadius(pData, stride, num_vertex);
 
 		if(view_level_ == -1) {
 			view_level_ = 0;
@@ -425,110 +659,402 @@ namespace GLRendering {
 	}
 
 	/**
-		* @brief Create Geometry as the order `position normal color`
+		* @brief Upload Geometry as the order `position normal color`
 		*
 	*/
-	std::shared_ptr<Geometry> Viewer::CreateGeometryPNC(const float* pData, const int stride,
+	bool Viewer::UploadGeometryPNC(GeometryArena& arena, const float* pData, const int stride,
                                   const int num_vertex,
-                                  unsigned int* indices, const int num_indices) {
+                                  const unsigned int* indices, const int num_indices,
+                                  const unsigned int* line_indices, const int num_line_indices,
+                                  ArenaRange& range) {
 		
-		const int vertexSize = stride * sizeof(float);
-		ProgramAttribute attribs[3];
-		int nAttribs = 3;
-		attribs[0].index = kPosition;
-		attribs[0].size = 3;
-		attribs[0].type = GL_FLOAT;
-		attribs[0].normalized = false;
-		attribs[0].stride = vertexSize;
-		attribs[0].offset = 0;
-
-		attribs[1].index = kNormal;
-		attribs[1].size = 3;
-		attribs[1].type = GL_FLOAT;
-		attribs[1].normalized = false;
-		attribs[1].stride = vertexSize;
-		attribs[1].offset = 3 * sizeof(float);
-
-		attribs[2].index = kColor;
-		attribs[2].size = 3;
-		attribs[2].type = GL_FLOAT;
-		attribs[2].normalized = false;
-		attribs[2].stride = vertexSize;
-		attribs[2].offset = 6 * sizeof(float);
+		if(!arena.BeginUpload(num_vertex, num_indices, num_line_indices, range)) {
+			return false;
+		}
+		std::memcpy(arena.MappedVertices(), pData, (size_t)num_vertex * stride * sizeof(float));
+		std::memcpy(arena.MappedIndices(), indices, num_indices * sizeof(unsigned int));
+		if(num_line_indices > 0) {
+			std::memcpy(arena.MappedIndices() + num_indices, line_indices, num_line_indices * sizeof(unsigned int));
+		}
+		if(!arena.FinishUpload()) {
+			arena.Release(range);
+			return false;
+		}
+		return true;
+	}
 
-		
+	ModelAttrib* Viewer::CreateMeshPacked(const int level, const SubDivision::IndexedTriangles& triangles,
+									const SubDivision::PackedVertexFormat& format,
+									const glm::vec3& modelColor, const glm::mat4& modelMatrix) {
+
+		if(!arena_.IsInitialized()) {
+			ProgramAttribute attribs[2];
+			PackedAttributes(format, attribs);
+			arena_.Initialize(&attribs[0], 2, format.Stride());
+			arena_format_ = format;
+		} else if(format.position != arena_format_.position || format.normal != arena_format_.normal) {
+			std::cerr << "vertex format " << format.Name() << " differs from the levels in the arena" << std::endl;
+			return nullptr;
+		}
 
-		std::shared_ptr<Geometry> new_model = std::make_shared<Geometry>();
-		new_model->Initialize(&attribs[0], nAttribs,
-							indices, num_indices,
-							(const void*)pData, vertexSize * num_vertex, num_vertex);
-		{
-			printf("INFO(BCHO): mnew_model[] != NULL %d\n",  new_model != NULL);
-			printf("INFO(BCHO): GetVertexCount %d\n", new_model->GetVertexCount());
-			printf("INFO(BCHO): GetIndexCount %d\n", new_model->GetIndexCount());
-			printf("INFO(BCHO): GetIbId %d\n", new_model->GetIbId());
-			printf("INFO(BCHO): GetVaoId %d\n", new_model->GetVaoId());
-			printf("INFO(BCHO): GetVbId %d\n", new_model->GetVbId());
+		const int idx = level;
+		if(models_.count(idx)) {
+			ReleaseLevel(idx);
+		}
+		SubDivision::PackedVertices vertices;
+		ArenaRange range;
+		if(!UploadGeometryPacked(arena_, triangles, format, vertices, range, &pool_)) {
+			return nullptr;
 		}
-    	return new_model;
+		models_[idx].arena = &arena_;
+		models_[idx].range = range;
+		models_[idx].modelMatrix = modelMatrix;
+		models_[idx].modelColor = modelColor;
+		models_[idx].renderingMode = GL_TRIANGLES;
+		models_[idx].positionScale = glm::vec3(vertices.position_scale[0], vertices.position_scale[1], vertices.position_scale[2]);
+		models_[idx].positionOffset = glm::vec3(vertices.position_offset[0], vertices.position_offset[1], vertices.position_offset[2]);
+		models_[idx].octahedralNormal = vertices.format.normal == SubDivision::kNormalOctahedral ? 1 : 0;
+		models_[idx].radius = BoundingRadius(triangles.vertex_data.data(), SubDivision::IndexedTriangles::kStride, triangles.NumVertices());
+
+		if(view_level_ == -1) {
+			view_level_ = 0;
+		}
+
+		return &(models_[idx]);
 	}
 
-	bool Viewer::Subdivision() {
+	bool Viewer::UploadGeometryPacked(GeometryArena& arena, const SubDivision::IndexedTriangles& triangles,
+                                  const SubDivision::PackedVertexFormat& format,
+                                  SubDivision::PackedVertices& vertices, ArenaRange& range, CommonUtils::ThreadPool* pool) {
 
-		size_t num_levels = config_.maximum_level;
-		std::vector<Eigen::Vector3d> vertices;
-		std::vector<std::vector<index_t>> polygons;
-		bool b_split_triangle = false;
-		if(used_method == 0) {
-			b_split_triangle = true; // split input mesh into triangles for loop subdivison 
+		//no staging copy: the records are packed and the indices copied straight into the mapped
+		//range, the pool has joined before `FinishUpload` hands it to the GPU
+		if(!arena.BeginUpload(triangles.NumVertices(), triangles.NumIndices(), triangles.NumEdgeIndices(), range)) {
+			return false;
 		}
-		if(!CommonUtils::LoadObj(config_.model_path, vertices, polygons,b_split_triangle)) {
+		SubDivision::PackVertices(triangles, format, (uint8_t*)arena.MappedVertices(), vertices, pool);
+		CopyIndices(pool, triangles.indices, arena.MappedIndices());
+		CopyIndices(pool, triangles.edge_indices, arena.MappedIndices() + triangles.NumIndices());
+		if(!arena.FinishUpload()) {
+			arena.Release(range);
 			return false;
 		}
-		std::vector<SubDivision::Mesh> meshes;
-		meshes.reserve(num_levels);
-		meshes.emplace_back(SubDivision::Mesh());
-		meshes[0].SetUp(vertices, polygons);
-		meshes[0].ScaleModel(3.0);
-		
-		//meshes[0].PrintObj();
-		//meshes[0]->PrintPolygon();
+		return true;
+	}
+
+	void Viewer::ReleaseModels() {
+		models_.clear();
+		arena_.Destroy();
+		pnc_arena_.Destroy();
+	}
+
+	void Viewer::ReleaseLevel(int level) {
+		auto it = models_.find(level);
+		if(it != models_.end()) {
+			it->second.arena->Release(it->second.range);
+			models_.erase(it);
+		}
+	}
+
+	void Viewer::StartSubdivision(int method) {
+		StopSubdivision();
+		ReleaseModels();
+		level_cache_.Clear();
+		level_progress_.clear();
+		view_level_ = -1;
+		pending_level_ = -1;
+		requested_level_ = 0;
+		worker_view_level_ = -1;
+		b_cancel_worker_ = false;
+		worker_ = std::thread([this, method]() {
+			if(!Subdivision(method)) {
+				std::cerr << "fail to subdivide " + config_.model_path << std::endl;
+			}
+			LevelMessage message;
+			message.kind = LevelMessage::kFinished;
+			PostLevel(std::move(message));
+		});
+	}
+
+	void Viewer::StopSubdivision() {
+		if(!worker_.joinable()) {
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(worker_mutex_);
+			b_cancel_worker_ = true;
+		}
+		worker_cv_.notify_one();
+		worker_.join();
+		level_queue_.Clear();  //the producer is gone, drop what it posted
+	}
+
+	bool Viewer::PostLevel(LevelMessage&& message) {
+		//the queue only fills up if the render thread stalls, wait for it rather than drop a level
+		while(!level_queue_.Push(std::move(message))) {
+			if(b_cancel_worker_) {
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		glfwPostEmptyEvent();  //wakes the render loop blocked in `glfwWaitEvents`
+		return !b_cancel_worker_;
+	}
+
+	bool Viewer::Subdivision(int method) {
+
+		const int num_levels = config_.maximum_level;
+		if(SubDivision::IsSmeshPath(config_.model_path)) {
+			return LoadSubdividedLevels();
+		}
 		SubDivision::SubDivisionSolver* division_solver;
 		SubDivision::CatmullClarkSolver clark_division_solver;
 		SubDivision::LoopSolver loop_division_solver;
 		SubDivision::DooSabinSolver doo_division_solver;
-		if(used_method == 0) {
+		if(method == 0) {
 			std::cout<<"Start Loop division\n";
 			division_solver = &loop_division_solver;
-		} else if(used_method == 1) {
+		} else if(method == 1) {
 			std::cout<<"Start CatmullClark division\n";
 			division_solver = &clark_division_solver;
 		}else {
 			std::cout<<"Start DooSabin division\n";
 			division_solver = &doo_division_solver;
 		}
-		
 
-		for(int i = 1 ; i < num_levels ; i++) {
-			std::cout<<"/////level "<<i<<"\n";
-			SubDivision::Mesh updated_mesh;
-			if(!division_solver->Run((meshes[i-1]), (updated_mesh))) {
-				break;
+		//only the last two levels are kept as `Mesh`, every level is compressed and posted
+		return ProduceLevels(num_levels, [&](int level, std::unique_ptr<SubDivision::Mesh>& mesh) {
+			if(level == 0) {
+				std::vector<Eigen::Vector3d> vertices;
+				std::vector<std::vector<index_t>> polygons;
+				bool b_split_triangle = false;
+				if(method == 0) {
+					b_split_triangle = true; // split input mesh into triangles for loop subdivison 
+				}
+				if(!CommonUtils::LoadObj(config_.model_path, vertices, polygons,b_split_triangle)) {
+					return false;
+				}
+				mesh.reset(new SubDivision::Mesh());
+				mesh->SetUp(vertices, polygons);
+				mesh->ScaleModel(3.0);
+				return true;
+			}
+			std::cout<<"/////level "<<level<<"\n";
+			std::unique_ptr<SubDivision::Mesh> updated_mesh(new SubDivision::Mesh());
+			SubDivision::SubdivisionStats stats;
+			if(!division_solver->Run(*mesh, *updated_mesh, &stats)) {
+				return false;
 			}
-			meshes.emplace_back(updated_mesh);
+			stats.Print();
+			mesh = std::move(updated_mesh);
+			return true;
+		});
+
+	}
+
+	bool Viewer::LoadSubdividedLevels() {
+		//levels were refined offline, only the topology tables are copied out of the mapped file
+		SubDivision::SmeshFile smesh_file;
+		if(!smesh_file.Open(config_.model_path)) {
+			return false;
 		}
-		num_levels = meshes.size();
+		const int num_levels = std::min<int>(smesh_file.NumLevels(), config_.maximum_level);
 		std::cout<<"max level : "<<num_levels<<"\n";
+		std::pair<Eigen::Vector3d, double> transform;
+		return num_levels > 0 && ProduceLevels(num_levels, [&](int level, std::unique_ptr<SubDivision::Mesh>& mesh) {
+			mesh.reset(new SubDivision::Mesh());
+			smesh_file.LoadLevel(level, *mesh);
+			if(level == 0) {
+				transform = mesh->ScaleModel(3.0);
+			} else {
+				mesh->TransformModel(transform.first, transform.second);  //same frame as level 0
+			}
+			return true;
+		});
+	}
 
+	bool Viewer::ProduceLevels(int num_levels, const std::function<bool(int, std::unique_ptr<SubDivision::Mesh>&)>& make_level) {
+		std::unique_ptr<SubDivision::Mesh> mesh;
 		for(int i = 0 ; i < num_levels ; i++) {
-            std::vector<float> pData;
-            size_t num_vertex;
-            std::tie(pData, num_vertex) = meshes[i].ConvertToTriangularMesh();
-            std::cout<<i<<" pData->size(): "<<pData.size()<<"\n";
-            CreateMeshPNC(pData.data(), 9, num_vertex, glm::vec3(0.4, 0.4, 0.0) ,glm::mat4(1.0));
-        }
+			if(i > 0 && !WaitForLevelRequest(i, mesh->MemoryBytes())) {
+				return true;  //cancelled
+			}
+			CommonUtils::Timer timer;
+			LevelMessage started;
+			started.level = i;
+			if(!PostLevel(std::move(started))) {
+				return true;
+			}
+			if(!make_level(i, mesh)) {
+				LevelMessage failed;
+				failed.kind = LevelMessage::kFailed;
+				failed.level = i;
+				PostLevel(std::move(failed));
+				return i > 0;  //a solver may stop early, a failed load is an error
+			}
+			LevelMessage ready;
+			ready.kind = LevelMessage::kReady;
+			ready.level = i;
+			ready.compressed.Encode(*mesh);
+			ready.seconds = timer.ElapsedSeconds();
+			if(!PostLevel(std::move(ready))) {
+				return true;
+			}
+		}
 		return true;
+	}
 
+	bool Viewer::WaitForLevelRequest(int level, size_t previous_bytes) {
+		//every scheme multiplies the number of polygons by about 4 per level
+		const size_t predicted_bytes = 4 * previous_bytes;
+		std::unique_lock<std::mutex> lock(worker_mutex_);
+		worker_cv_.wait(lock, [&]() {
+			if(b_cancel_worker_ || level <= requested_level_) {
+				return true;
+			}
+			//speculate a little ahead of the viewed level while the next mesh fits in the budget
+			return level <= worker_view_level_ + kSpeculationDepth && predicted_bytes <= kSpeculationBudget;
+		});
+		return !b_cancel_worker_;
+	}
+
+	void Viewer::RequestLevel(int level) {
+		{
+			std::lock_guard<std::mutex> lock(worker_mutex_);
+			requested_level_ = std::max(requested_level_, level);
+			worker_view_level_ = view_level_;
+		}
+		worker_cv_.notify_one();
+	}
+
+	bool Viewer::ReceiveLevels() {
+		LevelMessage message;
+		bool b_received = false;
+		while(level_queue_.Pop(message)) {
+			b_received = true;
+			if(message.kind == LevelMessage::kFinished) {
+				if(worker_.joinable()) {
+					worker_.join();
+				}
+				std::cout<<"max level : "<<level_cache_.NumLevels()<<", level cache: "<<level_cache_.MemoryBytes()<<" bytes\n";
+				continue;
+			}
+			if(message.level >= static_cast<int>(level_progress_.size())) {
+				level_progress_.resize(message.level + 1);
+			}
+			LevelProgress& progress = level_progress_[message.level];
+			if(message.kind == LevelMessage::kStarted) {
+				progress.state = LevelProgress::kComputing;
+			} else if(message.kind == LevelMessage::kFailed) {
+				progress.state = LevelProgress::kFailed;
+				pending_level_ = -1;
+				if(message.level == 0) {
+					b_initialization_window_ = true;  //nothing to show, let the user pick again
+				}
+			} else {
+				//levels are posted in order, so the cache index is the level
+				progress.state = LevelProgress::kReady;
+				progress.num_polygons = message.compressed.NumPolygons();
+				progress.seconds = message.seconds;
+				level_cache_.Add(std::move(message.compressed));
+				if(view_level_ == -1 || message.level == pending_level_) {
+					SelectLevel(message.level);
+				}
+			}
+		}
+		return b_received;
+	}
+
+	void Viewer::DisplayProgress() {
+		//one line per level at the bottom left, the view stays interactive while levels arrive
+		float y = -0.9f + 0.07f * level_progress_.size();
+		for(size_t i = 0 ; i < level_progress_.size() ; i++, y -= 0.07f) {
+			const LevelProgress& progress = level_progress_[i];
+			std::ostringstream line;
+			line<<"level "<<i<<": ";
+			if(progress.state == LevelProgress::kComputing) {
+				line<<"computing...";
+			} else if(progress.state == LevelProgress::kFailed) {
+				line<<"failed";
+			} else {
+				line<<"ready, "<<progress.num_polygons<<" polygons, "<<std::fixed<<std::setprecision(2)<<progress.seconds<<" s";
+			}
+			PutText(-0.9f, y, line.str());
+		}
+	}
+
+	bool Viewer::SelectLevel(int level) {
+		if(level < 0 || level >= static_cast<int>(level_cache_.NumLevels())) {
+			return false;
+		}
+		//the viewed level first, then the ones compared with it; uploaded levels stay in the arena
+		const int first_level = b_compare_levels_ ? std::max(0, level - kMaxDrawnLevels + 1) : level;
+		CommonUtils::Timer timer;
+		bool b_uploaded = false;
+		for(int i = level ; i >= first_level ; i--) {
+			if(!models_.count(i)) {
+				if(!UploadLevel(i, first_level, level)) {
+					return false;
+				}
+				b_uploaded = true;
+			}
+		}
+		if(b_uploaded) {
+			upload_ms_ = 1000.0 * timer.ElapsedSeconds();
+		}
+		view_level_ = level;
+		pending_level_ = -1;
+		RequestLevel(0);  //lets the worker speculate past the new view level
+		return true;
+	}
+
+	bool Viewer::UploadLevel(int level, int keep_first, int keep_last) {
+		SubDivision::IndexedTriangles triangles;
+		level_cache_.Level(level).DecodeIndexed(triangles, &pool_);
+		EvictLevels(vertex_format_.Stride() * triangles.NumVertices() +
+					(triangles.NumIndices() + triangles.NumEdgeIndices()) * sizeof(unsigned int), keep_first, keep_last);
+		std::vector<SubDivision::Meshlet> meshlets;
+		SubDivision::BuildMeshlets(triangles, meshlets, SubDivision::kMeshletTriangles, &pool_);
+		ModelAttrib* model = CreateMeshPacked(level, triangles, vertex_format_, glm::vec3(0.4, 0.4, 0.0) ,glm::mat4(1.0));
+		if(!model) {
+			return false;
+		}
+		model->meshlets = std::move(meshlets);
+		return true;
+	}
+
+	void Viewer::EvictLevels(size_t bytes, int keep_first, int keep_last) {
+		size_t resident_bytes = 0;
+		for(const auto& model : models_) {
+			resident_bytes += model.second.arena->GetRangeBytes(model.second.range);
+		}
+		//the level farthest from the kept ones goes first
+		while(resident_bytes + bytes > kResidentBudget) {
+			int farthest = -1, farthest_distance = 0;
+			for(const auto& model : models_) {
+				const int distance = model.first < keep_first ? keep_first - model.first : model.first - keep_last;
+				if(distance > farthest_distance) {
+					farthest = model.first;
+					farthest_distance = distance;
+				}
+			}
+			if(farthest == -1) {
+				return;
+			}
+			resident_bytes -= models_.at(farthest).arena->GetRangeBytes(models_.at(farthest).range);
+			ReleaseLevel(farthest);
+		}
+	}
+
+	std::vector<int> Viewer::DrawnLevels() const {
+		std::vector<int> levels;
+		const int first_level = b_compare_levels_ ? std::max(0, view_level_ - kMaxDrawnLevels + 1) : view_level_;
+		for(int level = first_level ; level <= view_level_ ; level++) {
+			if(models_.count(level)) {
+				levels.push_back(level);
+			}
+		}
+		return levels;
 	}
 
 	/**
@@ -560,17 +1086,40 @@ namespace GLRendering {
 			if (glfwGetKey(window_, GLFW_KEY_F) == GLFW_PRESS)
 			b_show_wireframe_ = !b_show_wireframe_;
 
-			if (glfwGetKey(window_, GLFW_KEY_W) == GLFW_PRESS) {
-				if(models_.count(view_level_ + 1)) {
-					view_level_ += 1;
-				}
+			if (glfwGetKey(window_, GLFW_KEY_W) == GLFW_PRESS && view_level_ >= 0 &&
+				!SelectLevel(view_level_ + 1) && view_level_ + 1 < config_.maximum_level) {
+				//not computed yet: ask the worker for it and show it when it arrives
+				pending_level_ = view_level_ + 1;
+				RequestLevel(pending_level_);
 			}
 
 			if (glfwGetKey(window_, GLFW_KEY_S) == GLFW_PRESS) {
-				if(models_.count(view_level_ - 1)) {
-					view_level_ -= 1;
-				}
+				SelectLevel(view_level_ - 1);
 			}
+
+			if (glfwGetKey(window_, GLFW_KEY_P) == GLFW_PRESS) {
+				//upload the viewed level again in the next vertex format
+				const int num_formats = sizeof(kVertexFormats) / sizeof(kVertexFormats[0]);
+				vertex_format_index_ = (vertex_format_index_ + 1) % num_formats;
+				vertex_format_ = kVertexFormats[vertex_format_index_];
+				ReleaseModels();
+				SelectLevel(view_level_);
+			}
+
+			if (glfwGetKey(window_, GLFW_KEY_K) == GLFW_PRESS)
+			b_cull_clusters_ = !b_cull_clusters_;
+
+			if (glfwGetKey(window_, GLFW_KEY_V) == GLFW_PRESS) {
+				//the previous levels join the viewed one in its submission
+				b_compare_levels_ = !b_compare_levels_;
+				SelectLevel(view_level_);
+			}
+
+			if (glfwGetKey(window_, GLFW_KEY_H) == GLFW_PRESS)
+			b_show_stats_ = !b_show_stats_;
+
+			if (glfwGetKey(window_, GLFW_KEY_R) == GLFW_PRESS)
+			b_continuous_ = !b_continuous_;
 		}
 			
 	}
@@ -602,6 +1151,7 @@ namespace GLRendering {
 		// make sure the viewport matches the new window_ dimensions; note that width and 
 		// height will be significantly larger than specified on retina displays.
 		glViewport(0, 0, width, height);
+		Viewer::Instance().RequestRedraw();
 	}
 	/**
 	* @brief Implementation of mouse button clicking callback function
@@ -616,6 +1166,10 @@ namespace GLRendering {
 		int RIGHT_BUTTON = glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_RIGHT);
 
 
+		if (LEFT_BUTTON == GLFW_PRESS || MIDDLE_BUTTON == GLFW_PRESS || RIGHT_BUTTON == GLFW_PRESS) {
+			Viewer::Instance().RequestRedraw();  //the camera moves
+		}
+
 		if (LEFT_BUTTON == GLFW_PRESS) {
 			camera->ProcessMouseButton(MouseButton::LEFT_BUTTON, x, y);
 
@@ -2,23 +2,100 @@
 #include "gl_camera.h"
 #include "gl_geometry.h"
 #include "gl_shader.h"
+#include "gl_timer.h"
 #define GLEW_STATIC
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <memory>
 #include <map>
 #include <functional>
+#include <fstream>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 //used by subdivision
 #include "utils/config.h"
+#include "utils/spsc_queue.h"
+#include "utils/thread_pool.h"
+#include "subdivision/level_cache.h"
+#include "subdivision/vertex_packing.h"
+#include "subdivision/meshlets.h"
 
 namespace GLRendering {
 
 	struct ModelAttrib{
-			std::shared_ptr<Geometry> model;
-			std::vector<float> edges_data;
+			GeometryArena* arena = nullptr;  //holds `range` next to the other meshes of the same vertex layout
+			ArenaRange range;  //wireframe: its line indices over the same vertices
 			glm::mat4 modelMatrix;
 			glm::vec3 modelColor;
 			GLenum renderingMode;
+			//dequantisation and normal decoding of packed vertices, see `SubDivision::PackedVertices`
+			glm::vec3 positionScale = glm::vec3(1.0f);
+			glm::vec3 positionOffset = glm::vec3(0.0f);
+			unsigned int octahedralNormal = 0;
+			std::vector<SubDivision::Meshlet> meshlets;  //clusters of the triangle indices, culled in `Render`
+			float radius = 0.0f;  //of the sphere around the model origin holding every vertex
+	};
+
+	//`FrameUniforms` block of model_v.glsl/model_f.glsl in std140 layout (vec3 padded to vec4),
+	//written once per frame into one uniform buffer shared by every draw.
+	struct FrameUniforms {
+		glm::mat4 projectionMatrix;
+		glm::mat4 viewMatrix;
+		glm::vec4 eyePos;
+		glm::vec4 lightPos;
+	};
+
+	//Per draw uniforms, resolved once after the shader is linked.
+	struct ModelUniforms {
+		UniformHandle<glm::mat4> modelMatrix;
+		UniformHandle<glm::vec3> modelColor;
+		UniformHandle<unsigned int> octahedralNormal;
+	};
+
+	//Levels drawn by one submission, the size of the array of `LevelUniforms` in model_v.glsl.
+	const int kMaxDrawnLevels = 8;
+
+	//One level of `LevelUniforms` (model_v.glsl, std140). A vertex finds its level by its index,
+	//`gl_VertexID` includes the base vertex of the range it is drawn from.
+	struct DrawnLevel {
+		glm::vec4 placement;  //xyz: translation in view space, w: scale, side by side in the comparison
+		glm::vec4 positionScale;  //xyz, dequantisation of packed vertices
+		glm::vec4 positionOffset;  //xyz
+		glm::ivec4 vertexRange;  //x: first vertex in the arena, y: one past the last
+	};
+
+	struct LevelUniforms {
+		DrawnLevel levels[kMaxDrawnLevels];
+		int numLevels;
+		int padding[3];
+	};
+
+	//Numbers of the performance overlay (H) and of the frame log.
+	struct FrameStats {
+		double cpu_ms = 0.0;  //input, level uploads and draw calls of the last frame, without the buffer swap
+		double gpu_ms = -1.0;  //of the latest finished timer query, a frame or two behind
+		size_t num_triangles = 0;  //submitted in this frame, after cluster culling
+		size_t num_vertices = 0;  //of the drawn levels
+		size_t buffer_bytes = 0;  //vertex and index buffers of the arenas, resident on the GPU
+	};
+
+	//Posted by the subdivision worker to the render thread.
+	struct LevelMessage {
+		enum Kind { kStarted, kReady, kFailed, kFinished };
+		Kind kind = kStarted;
+		int level = 0;
+		SubDivision::CompressedLevel compressed;  //kReady only
+		double seconds = 0.0;
+	};
+
+	//What the progress indicator shows for one level.
+	struct LevelProgress {
+		enum State { kComputing, kReady, kFailed };
+		State state = kComputing;
+		size_t num_polygons = 0;
+		double seconds = 0.0;
 	};
 
 	class Viewer {
@@ -30,7 +107,7 @@ namespace GLRendering {
 		
 		Viewer(const Viewer &) = delete;
 		Viewer &operator=(const Viewer &) = delete;
-		~Viewer() {}
+		~Viewer() { StopSubdivision(); }
 		Viewer();
 
 		
@@ -58,32 +135,78 @@ namespace GLRendering {
 		*/
 		void Run();
 
-		void RenderFixed(const ModelAttrib& modelItem);
-
-
-		void Render(ModelAttrib& modelItem);
+		//every level of `levels` side by side, the ones in the same arena in one submission
+		void Render(const std::vector<int>& levels);
 
 		void Display();
 
-		ModelAttrib* CreateMeshPNC(const float* pData, const int stride, const int num_vertex, const glm::vec3& modelColor,
-										const glm::mat4& modelMatrix);
+		//render thread, e.g. from the input callbacks: draw a frame even in render-on-demand mode
+		void RequestRedraw() { b_redraw_ = true; }
+
+		ModelAttrib* CreateMeshPNC(const int level, const float* pData, const int stride, const int num_vertex,
+										const glm::vec3& modelColor, const glm::mat4& modelMatrix);
+		//vertices shared by an index buffer, e.g. from `Mesh::ConvertToIndexedMesh`,
+		//`line_indices` are the edges drawn in wireframe mode
+		ModelAttrib* CreateMeshPNC(const int level, const float* pData, const int stride, const int num_vertex,
+										const unsigned int* indices, const int num_indices,
+										const unsigned int* line_indices, const int num_line_indices,
+										const glm::vec3& modelColor, const glm::mat4& modelMatrix);
+		//vertices in one of the compact formats of `SubDivision::PackedVertexFormat`, streamed into
+		//a mapped range of the arena (`GeometryArena::BeginUpload`), null if it could not be mapped
+		//or `format` is not the one of the levels already in the arena
+		ModelAttrib* CreateMeshPacked(const int level, const SubDivision::IndexedTriangles& triangles,
+										const SubDivision::PackedVertexFormat& format,
+										const glm::vec3& modelColor, const glm::mat4& modelMatrix);
 		
 
 
-		bool Subdivision(); //indenpent to rendering pipeline
+		//Load and refinement run on a worker thread, every finished level is compressed there and
+		//posted through `level_queue_`, the render thread uploads it in `ReceiveLevels()`.
+		//Level 0 is computed at once, a deeper level only when W reaches it or speculatively
+		//(up to `kSpeculationDepth` past the viewed level, while it fits in `kSpeculationBudget`).
+		void StartSubdivision(int method);
+		void StopSubdivision();  //cancel the worker between two levels and join it
+		bool Subdivision(int method); //worker side, indenpent to rendering pipeline
+		bool LoadSubdividedLevels(); //worker side, `config_.model_path` is a .smesh with the levels precomputed
+		//decode `level` from the level cache, and the levels compared with it (V), into the arena
+		bool SelectLevel(int level);
 
 
 
 	private:
-		static std::shared_ptr<Geometry> CreateGeometryPNC(const float* pData, const int stride,
+		static bool UploadGeometryPNC(GeometryArena& arena, const float* pData, const int stride,
                                   const int num_vertex,
-                                  unsigned int* indices, const int num_indices); //analogous to SimpleApp::CreateFromObjFile
+                                  const unsigned int* indices, const int num_indices,
+                                  const unsigned int* line_indices, const int num_line_indices,
+                                  ArenaRange& range); //analogous to SimpleApp::CreateFromObjFile
+		static bool UploadGeometryPacked(GeometryArena& arena, const SubDivision::IndexedTriangles& triangles,
+                                  const SubDivision::PackedVertexFormat& format,
+                                  SubDivision::PackedVertices& vertices, ArenaRange& range, CommonUtils::ThreadPool* pool);
 		static bool InitializeShader(Shader &whichShader, const char *vertexPath, const char *fragmentPath,
                      				 const char *vertexName, const char *fragmentName);
 
 		void ResetContollingVariables();
+		void ReleaseModels();  //every resident level and the arenas
+		void ReleaseLevel(int level);  //its range of the arena
+		//decode and upload `level`, first releasing levels outside [keep_first, keep_last] if the
+		//resident ones would not fit in `kResidentBudget` with it
+		bool UploadLevel(int level, int keep_first, int keep_last);
+		void EvictLevels(size_t bytes, int keep_first, int keep_last);
+		std::vector<int> DrawnLevels() const;  //the viewed level, after the levels compared with it
 		void DisplayInitializationWindow();
 		void PutText(float x, float y, std::string str);
+		void DisplayProgress();
+		void DisplayStats();
+		void LogFrame();  //one row of `config_.frame_log_path`
+		//frustum and backface culling of the clusters, the survivors are appended to the next multi-draw
+		void AppendVisibleClusters(const ModelAttrib& modelItem, const glm::mat4& clipFromModel, const glm::mat4& viewFromModel);
+		void AppendDrawRange(GLsizei count, size_t first_index, GLint base_vertex);  //merged with the last one if contiguous
+		bool PostLevel(LevelMessage&& message);  //worker side, false once cancelled
+		//worker side: produce levels 0..num_levels-1, `make_level(i, mesh)` turns level i-1 into level i
+		bool ProduceLevels(int num_levels, const std::function<bool(int, std::unique_ptr<SubDivision::Mesh>&)>& make_level);
+		bool WaitForLevelRequest(int level, size_t previous_bytes);  //worker side, false once cancelled
+		void RequestLevel(int level);  //render side, also publishes `view_level_` to the worker
+		bool ReceiveLevels();  //render side, called once per loop iteration, true if anything arrived
 		
 
 		/**
@@ -98,9 +221,50 @@ namespace GLRendering {
 		bool b_setup_;
 		std::string vertex_shader_path_, fragment_shader_path_;
 		glm::vec3 light_pos_;
-		std::map<int, ModelAttrib> models_;
+		std::map<int, ModelAttrib> models_;  //resident levels: the viewed and compared ones, earlier ones while they fit
+		GeometryArena arena_;  //every resident level, in `arena_format_`
+		SubDivision::PackedVertexFormat arena_format_;
+		GeometryArena pnc_arena_;  //meshes of `CreateMeshPNC`, float records
+		static const size_t kResidentBudget = size_t(1) << 30;  //vertex and index bytes of the resident levels
+		SubDivision::LevelCache level_cache_;  //every level, compressed, owned by the render thread
+		CommonUtils::ThreadPool pool_;  //builds the index buffers of a selected level
+		SubDivision::PackedVertexFormat vertex_format_;  //of the uploaded levels, P cycles `kVertexFormats`
+		int vertex_format_index_ = 0;
+		std::vector<LevelProgress> level_progress_;
+		CommonUtils::SpscQueue<LevelMessage> level_queue_{16};
+		std::thread worker_;
+		std::atomic<bool> b_cancel_worker_{false};
+		std::mutex worker_mutex_;
+		std::condition_variable worker_cv_;
+		int requested_level_ = 0;  //guarded by `worker_mutex_`
+		int worker_view_level_ = -1;  //copy of `view_level_` for the worker, guarded by `worker_mutex_`
+		int pending_level_ = -1;  //requested with W, selected when it arrives
+		static const int kSpeculationDepth = 1;
+		static const size_t kSpeculationBudget = size_t(1) << 30;  //predicted bytes of a speculated `Mesh`
 		bool b_show_wireframe_;
+		bool b_cull_clusters_ = true;  //K
+		bool b_compare_levels_ = false;  //V: up to `kMaxDrawnLevels` levels side by side
+		bool b_show_stats_ = false;  //H
+		//render on demand: the loop blocks in `glfwWaitEvents` until input, a resize or a level from
+		//the worker (`glfwPostEmptyEvent`) asks for a frame, R switches to redrawing continuously
+		bool b_redraw_ = true;
+		bool b_continuous_ = false;
+		static constexpr double kOverlayRefreshSeconds = 0.25;  //idle redraws while the overlay is shown
+		FrameStats frame_stats_;
+		GpuTimer gpu_timer_;
+		double upload_ms_ = 0.0;  //decoding, clustering and upload of the levels of the last selection
+		std::ofstream frame_log_;
+		size_t num_frames_ = 0;
+		size_t num_drawn_clusters_ = 0;  //in the last frame
+		std::vector<GLsizei> draw_counts_;  //ranges of the last multi-draw
+		std::vector<const void*> draw_offsets_;
+		std::vector<GLint> draw_base_vertices_;
 		Shader shader_;
+		ModelUniforms model_uniforms_;
+		UniformBuffer frame_uniforms_;
+		static const unsigned int kFrameUniformsBinding = 0;
+		UniformBuffer level_uniforms_;
+		static const unsigned int kLevelUniformsBinding = 1;
 		GLFWwindow* window_;
 		const bool verbose = false;
 		int view_level_;
@@ -163,6 +327,17 @@ namespace GLRendering {
 		static void MouseMotionCallback(GLFWwindow* window, double x, double y) {
 			CallBackController::Instance().MouseMotionCallbackImpl(window, x, y);
 		}
+		/**
+		* @brief Key and window refresh callback functions, they only ask the viewer for a new frame
+		*
+		* @param[in] window
+		*/
+		static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+			Viewer::Instance().RequestRedraw();
+		}
+		static void WindowRefreshCallback(GLFWwindow* window) {
+			Viewer::Instance().RequestRedraw();
+		}
 		
 		///////////////////////////////////////////
 		// OpenGL CallBack Implementation
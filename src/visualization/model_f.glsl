@@ -2,11 +2,16 @@
 
 in vec3 vWorldPos;
 in vec3 vWorldNormal;
-in vec3 vModelColor;
 
 uniform vec3 modelColor;
-uniform vec3 eyePos;
-uniform vec3 lightPos;
+//per frame, shared by every draw: `FrameUniforms` of gl_viewer.h, std140 so vec3 is padded to vec4
+layout(std140) uniform FrameUniforms
+{
+    mat4 projectionMatrix;
+    mat4 viewMatrix;
+    vec4 eyePos;    //xyz
+    vec4 lightPos;  //xyz
+};
 
 out highp vec4 outColor;
 
@@ -2,22 +2,67 @@
 
 in vec3 position;
 in vec3 normal;
-in vec3 color;
 
-uniform mat4 projectionMatrix;
-uniform mat4 viewMatrix;
+//per frame, shared by every draw: `FrameUniforms` of gl_viewer.h, std140 so vec3 is padded to vec4
+layout(std140) uniform FrameUniforms
+{
+    mat4 projectionMatrix;
+    mat4 viewMatrix;
+    vec4 eyePos;    //xyz
+    vec4 lightPos;  //xyz
+};
 uniform mat4 modelMatrix;
 
+//levels drawn by one submission from the shared buffers: `LevelUniforms` of gl_viewer.h, the
+//array is `kMaxDrawnLevels` long. A vertex finds its level by gl_VertexID, which includes the
+//base vertex of the range it is drawn from.
+struct DrawnLevel
+{
+    vec4 placement;       //xyz: translation in view space, w: scale
+    vec4 positionScale;   //xyz, packed vertices: position * positionScale + positionOffset is the model space position
+    vec4 positionOffset;  //xyz
+    ivec4 vertexRange;    //x: first vertex, y: one past the last
+};
+layout(std140) uniform LevelUniforms
+{
+    DrawnLevel levels[8];
+    int numLevels;
+};
+//1: normal.xy is the octahedral map of the normal
+uniform uint octahedralNormal;
+
 out vec3 vWorldPos;
 out vec3 vWorldNormal;
-out vec3 vModelColor;
+
+vec3 DecodeNormal(vec3 n)
+{
+    if(octahedralNormal == 0u) {
+        return n;
+    }
+    vec3 m = vec3(n.xy, 1.0 - abs(n.x) - abs(n.y));
+    if(m.z < 0.0) {
+        vec2 signs = vec2(m.x >= 0.0 ? 1.0 : -1.0, m.y >= 0.0 ? 1.0 : -1.0);
+        m.xy = (1.0 - abs(m.yx)) * signs;
+    }
+    return normalize(m);
+}
+
+int FindLevel()
+{
+    int i = 0;
+    while(i + 1 < numLevels && (gl_VertexID < levels[i].vertexRange.x || gl_VertexID >= levels[i].vertexRange.y)) {
+        i++;
+    }
+    return i;
+}
 
 void main()
 {
-    gl_Position = projectionMatrix * (viewMatrix * (modelMatrix * vec4(position, 1.0)));
-    vWorldPos = (modelMatrix * vec4(position.xyz, 1.0)).xyz;
+    int level = FindLevel();
+    vec3 modelPos = (position * levels[level].positionScale.xyz + levels[level].positionOffset.xyz) * levels[level].placement.w;
+    vWorldPos = (modelMatrix * vec4(modelPos, 1.0)).xyz + levels[level].placement.xyz;
+    gl_Position = projectionMatrix * (viewMatrix * vec4(vWorldPos, 1.0));
     // Only rotate the rest of these!
-    vWorldNormal = (modelMatrix * vec4(normal.xyz, 0.0)).xyz;
-    vModelColor = color;
+    vWorldNormal = (modelMatrix * vec4(DecodeNormal(normal), 0.0)).xyz;
 
 }
@@ -0,0 +1,34 @@
+# Write gen:${SPEC} at level 0 and refine it one Catmull-Clark level. The generated mesh must be
+# within a factor 2 of the requested ${NUM_FACES} faces, and the refined mesh must have one quad
+# per corner of the generated mesh.
+function(count_faces path faces corners)
+  file(STRINGS ${path} polygons REGEX "^f ")
+  list(LENGTH polygons num_polygons)
+  set(num_corners 0)
+  foreach(polygon IN LISTS polygons)
+    string(REGEX MATCHALL "[^ ]+" tokens "${polygon}")
+    list(LENGTH tokens num_tokens)
+    math(EXPR num_corners "${num_corners} + ${num_tokens} - 1")
+  endforeach()
+  set(${faces} ${num_polygons} PARENT_SCOPE)
+  set(${corners} ${num_corners} PARENT_SCOPE)
+endfunction()
+
+foreach(level 0 1)
+  execute_process(COMMAND ${SUBDIVIDE} -i gen:${SPEC} -s catmull -l ${level} -o ${OUTPUT}_${level}.obj
+                  RESULT_VARIABLE result OUTPUT_QUIET)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "subdivide -i gen:${SPEC} -l ${level} failed: ${result}")
+  endif()
+endforeach()
+
+count_faces(${OUTPUT}_0.obj num_faces num_corners)
+math(EXPR min_faces "${NUM_FACES} / 2")
+math(EXPR max_faces "${NUM_FACES} * 2")
+if(num_faces LESS min_faces OR num_faces GREATER max_faces)
+  message(FATAL_ERROR "gen:${SPEC} has ${num_faces} faces, expected about ${NUM_FACES}")
+endif()
+count_faces(${OUTPUT}_1.obj num_refined_faces num_refined_corners)
+if(NOT num_refined_faces EQUAL num_corners)
+  message(FATAL_ERROR "gen:${SPEC} level 1 has ${num_refined_faces} faces, expected ${num_corners}")
+endif()
@@ -0,0 +1,12 @@
+# Refine tests/uv_seam.obj one Catmull-Clark level with -uv and check the number of vt records:
+# 8 kept corner values, 6 boundary edge values, 2 on the seam edge (one per side), 2 face values.
+execute_process(COMMAND ${SUBDIVIDE} -i ${INPUT} -s catmull -l 1 -uv -o ${OUTPUT}
+                RESULT_VARIABLE result OUTPUT_QUIET)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "subdivide failed: ${result}")
+endif()
+file(STRINGS ${OUTPUT} texcoords REGEX "^vt ")
+list(LENGTH texcoords num_texcoords)
+if(NOT num_texcoords EQUAL 18)
+  message(FATAL_ERROR "expected 18 vt records, got ${num_texcoords}")
+endif()